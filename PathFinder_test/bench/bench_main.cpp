@@ -0,0 +1,289 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "../src/solvers.h"
+
+#include <scgms/rtl/SolverLib.h>
+#include <scgms/utils/string_utils.h>
+
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <cstring>
+
+//Microbenchmarks, which separate the costs the end-to-end pathfinder_test mixes:
+//ns per Calculate_Fitness call of each problem across the dimensions, and the solvers' own overhead
+//per generation and per evaluation, measured against a zero-cost objective.
+
+namespace {
+	struct TBench_Options {
+		std::vector<size_t> dimensions = { 2, 10, 100, 1000 };
+		size_t repetitions = 10;
+		double repetition_seconds = 0.02;	//of a kernel measurement, the calls per repetition are calibrated to it
+		size_t max_generations = 1000;
+		size_t population_size = 40;
+		bool kernels = true, solvers = true;
+		std::string json_file;	//empty - stdout
+	};
+
+	struct TKernel_Measurement {
+		std::string problem;
+		size_t dimension, calls_per_repetition;
+		CStats ns_per_call;
+	};
+
+	struct TSolver_Measurement {
+		std::wstring solver;
+		GUID id;
+		size_t dimension;
+		CStats generations, evaluations, ns_per_generation, ns_per_evaluation;
+	};
+
+	std::vector<size_t> Parse_Sizes(const std::string &text) {
+		std::vector<size_t> sizes;
+		std::istringstream stream{ text };
+		std::string item;
+		while (std::getline(stream, item, ','))
+			if (!item.empty()) sizes.push_back(std::strtoull(item.c_str(), nullptr, 10));
+		return sizes;
+	}
+
+	double Elapsed_Nanoseconds(const std::chrono::steady_clock::time_point &start) {
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::vector<TKernel_Measurement> Measure_Kernels(const TBench_Options &options) {
+		std::vector<TKernel_Measurement> measurements;
+		std::mt19937_64 random_generator{ 20181 };
+		volatile double sink = 0.0;	//keeps the timed calls alive
+
+		for (const size_t dimension : options.dimensions) {
+			const auto problems = Create_Problem_Collection(dimension);
+			for (const auto &problem : problems) {
+				if (!problem->Can_Be_Solved()) continue;
+
+				//a fixed pool of candidates within the bounds, cycled through
+				constexpr size_t candidate_count = 256;
+				CSolution lower_bound, upper_bound;
+				problem->get_bounds(lower_bound, upper_bound);
+				std::vector<double> candidates(candidate_count * dimension);
+				for (size_t i = 0; i < candidate_count; i++)
+					for (size_t d = 0; d < dimension; d++)
+						candidates[i * dimension + d] = std::uniform_real_distribution<double>{ lower_bound[d], upper_bound[d] }(random_generator);
+
+				auto time_calls = [&](const size_t calls) {
+					const auto start = std::chrono::steady_clock::now();
+					for (size_t c = 0; c < calls; c++)
+						sink = sink + problem->Calculate_Fitness(candidates.data() + (c % candidate_count) * dimension);
+					return Elapsed_Nanoseconds(start);
+				};
+
+				//calibrate, which also warms up
+				size_t calls = 16;
+				for (double ns = time_calls(calls); (ns < options.repetition_seconds * 1e9) && (calls < (size_t(1) << 30)); ns = time_calls(calls))
+					calls *= 2;
+
+				TKernel_Measurement measurement{ problem->Get_Name(), dimension, calls };
+				for (size_t r = 0; r < options.repetitions; r++)
+					measurement.ns_per_call.push_back(time_calls(calls) / static_cast<double>(calls));
+				measurement.ns_per_call.Calculate_Stats();
+				problem->reset_counters();
+
+				std::cout << measurement.problem << "; " << dimension << "; " << measurement.ns_per_call.Get_Stats().med << std::endl;
+				measurements.push_back(std::move(measurement));
+			}
+		}
+
+		return measurements;
+	}
+
+	//the zero-cost objective, it only counts the evaluations; atomically, as the multi-threaded solvers call it concurrently
+	BOOL IfaceCalling Zero_Objective(const void* data, const size_t count, const double* solution, double* const fitness) {
+		auto &evaluations = *const_cast<std::atomic<size_t>*>(static_cast<const std::atomic<size_t>*>(data));
+		evaluations.fetch_add(count, std::memory_order_relaxed);
+		for (size_t i = 0; i < count; i++)
+			fitness[i] = 0.0;
+		return TRUE;
+	}
+
+	std::vector<TSolver_Measurement> Measure_Solvers(const TBench_Options &options) {
+		std::vector<TSolver_Measurement> measurements;
+
+		for (const auto &solver : scgms::get_solver_descriptor_list()) {
+			//the distributed solver evaluates remotely, thus it has no local objective to measure against
+			if (!Is_Solver_Allowed(solver) || solver.specialized || (solver.id == diagnostic::scgms_distributed_solver::distributed_solver_generic)) continue;
+
+			for (const size_t dimension : options.dimensions) {
+				if (Is_Solver_Faulty(solver.id, dimension)) continue;
+
+				TSolver_Measurement measurement{ solver.description, solver.id, dimension };
+				std::vector<double> lower_bound(dimension, -5.0), upper_bound(dimension, 5.0), solution(dimension, 0.0);
+
+				for (size_t r = 0; r < options.repetitions; r++) {
+					std::atomic<size_t> evaluations{ 0 };
+					solver::TSolver_Setup setup{ dimension, 1,
+						lower_bound.data(), upper_bound.data(),
+						nullptr, 0,
+						solution.data(),
+						&evaluations, &Zero_Objective, nullptr,
+						options.max_generations, options.population_size, std::numeric_limits<double>::min(),
+					};
+					solver::TSolver_Progress progress{ 0 };
+
+					const auto start = std::chrono::steady_clock::now();
+					const HRESULT rc = solver::Solve_Generic(solver.id, setup, progress);
+					const double ns = Elapsed_Nanoseconds(start);
+					if (rc != S_OK) continue;
+
+					const double generations = static_cast<double>(progress.current_progress);
+					measurement.generations.push_back(generations);
+					const size_t evaluated = evaluations.load();
+					measurement.evaluations.push_back(static_cast<double>(evaluated));
+					if (generations > 0.0) measurement.ns_per_generation.push_back(ns / generations);
+					if (evaluated > 0) measurement.ns_per_evaluation.push_back(ns / static_cast<double>(evaluated));
+				}
+
+				measurement.generations.Calculate_Stats();
+				measurement.evaluations.Calculate_Stats();
+				measurement.ns_per_generation.Calculate_Stats();
+				measurement.ns_per_evaluation.Calculate_Stats();
+
+				std::wcout << measurement.solver << L"; " << dimension << L"; " << measurement.ns_per_generation.Get_Stats().med << L"; " << measurement.ns_per_evaluation.Get_Stats().med << std::endl;
+				measurements.push_back(std::move(measurement));
+			}
+		}
+
+		return measurements;
+	}
+
+	std::string Format_Double(const double value) {
+		if (!std::isfinite(value)) return "null";
+		std::ostringstream str;
+		str.precision(std::numeric_limits<double>::max_digits10);
+		str << value;
+		return str.str();
+	}
+
+	std::string Stats_JSON(CStats &stats) {
+		const auto &s = stats.Get_Stats();
+		return "{\"n\":" + std::to_string(stats.size()) + ",\"avg\":" + Format_Double(s.avg) + ",\"stddev\":" + Format_Double(s.stddev) + ",\"min\":" + Format_Double(s.min)
+			+ ",\"q25\":" + Format_Double(s.q25) + ",\"med\":" + Format_Double(s.med) + ",\"q75\":" + Format_Double(s.q75) + ",\"max\":" + Format_Double(s.max) + "}";
+	}
+
+	void Write_JSON(std::ostream &out, std::vector<TKernel_Measurement> &kernels, std::vector<TSolver_Measurement> &solvers, const TBench_Options &options) {
+		out << "{\"repetitions\":" << options.repetitions << ",\"kernels\":[";
+		for (size_t i = 0; i < kernels.size(); i++) {
+			out << (i > 0 ? "," : "") << "{\"problem\":\"" << kernels[i].problem << "\",\"dimension\":" << kernels[i].dimension
+				<< ",\"calls_per_repetition\":" << kernels[i].calls_per_repetition << ",\"ns_per_call\":" << Stats_JSON(kernels[i].ns_per_call) << "}";
+		}
+
+		out << "],\"solvers\":[";
+		for (size_t i = 0; i < solvers.size(); i++) {
+			out << (i > 0 ? "," : "") << "{\"solver\":\"" << Narrow_WString(solvers[i].solver) << "\",\"solver_id\":\"" << Narrow_WString(GUID_To_WString(solvers[i].id))
+				<< "\",\"dimension\":" << solvers[i].dimension << ",\"population_size\":" << options.population_size << ",\"max_generations\":" << options.max_generations
+				<< ",\"generations\":" << Stats_JSON(solvers[i].generations) << ",\"evaluations\":" << Stats_JSON(solvers[i].evaluations)
+				<< ",\"ns_per_generation\":" << Stats_JSON(solvers[i].ns_per_generation) << ",\"ns_per_evaluation\":" << Stats_JSON(solvers[i].ns_per_evaluation) << "}";
+		}
+		out << "]}" << std::endl;
+	}
+}
+
+int __cdecl main(int argc, char* argv[]) {
+	TBench_Options options;
+
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "-dimensions=", 12) == 0)
+			options.dimensions = Parse_Sizes(argv[i] + 12);
+		else if (strncmp(argv[i], "-repetitions=", 13) == 0)
+			options.repetitions = std::strtoull(argv[i] + 13, nullptr, 10);
+		else if (strncmp(argv[i], "-repetition_seconds=", 20) == 0)
+			options.repetition_seconds = std::atof(argv[i] + 20);
+		else if (strncmp(argv[i], "-generations=", 13) == 0)
+			options.max_generations = std::strtoull(argv[i] + 13, nullptr, 10);
+		else if (strncmp(argv[i], "-population=", 12) == 0)
+			options.population_size = std::strtoull(argv[i] + 12, nullptr, 10);
+		else if (strcmp(argv[i], "-kernels") == 0)
+			options.solvers = false;
+		else if (strcmp(argv[i], "-solvers") == 0)
+			options.kernels = false;
+		else if (strncmp(argv[i], "-json=", 6) == 0)
+			options.json_file = argv[i] + 6;
+		else {
+			std::cout << "Usage: pathfinder_bench [-kernels|-solvers] [-dimensions=2,10,100,1000] [-repetitions=10] [-repetition_seconds=0.02]" << std::endl
+					  << "                        [-generations=1000] [-population=40] [-json=file]" << std::endl;
+			return 1;
+		}
+	}
+
+	if (options.dimensions.empty() || (options.repetitions == 0)) {
+		std::cout << "Nothing to measure." << std::endl;
+		return 1;
+	}
+
+	//the progress goes to stderr, so that the json on stdout stays clean
+	std::vector<TKernel_Measurement> kernels;
+	std::vector<TSolver_Measurement> solvers;
+	auto *const console = std::cout.rdbuf(std::cerr.rdbuf());
+	std::wstreambuf *const wconsole = std::wcout.rdbuf(std::wcerr.rdbuf());
+	if (options.kernels) {
+		std::cout << "problem; dimension; median ns per call" << std::endl;
+		kernels = Measure_Kernels(options);
+	}
+	if (options.solvers) {
+		std::cout << "solver; dimension; median ns per generation; median ns per evaluation" << std::endl;
+		solvers = Measure_Solvers(options);
+	}
+	std::cout.rdbuf(console);
+	std::wcout.rdbuf(wconsole);
+
+	if (options.json_file.empty())
+		Write_JSON(std::cout, kernels, solvers, options);
+	else {
+		std::ofstream file{ options.json_file };
+		if (!file.is_open()) {
+			std::cout << "Cannot write " << options.json_file << std::endl;
+			return 1;
+		}
+		Write_JSON(file, kernels, solvers, options);
+	}
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "anytime_report.h"
+
+#include <iostream>
+#include <cmath>
+
+std::vector<double> Anytime_Targets(const size_t per_decade) {
+	std::vector<double> targets;
+	for (size_t i = 0; i <= 10 * per_decade; i++)
+		targets.push_back(std::pow(10.0, 2.0 - static_cast<double>(i) / static_cast<double>(per_decade)));
+	return targets;
+}
+
+double Calls_To_Target(const std::vector<TConvergence_Point> &trace, const double target) {
+	//the trace is sampled at the checkpoints only, hence the result is the first checkpoint at which the target was met
+	for (const auto &point : trace)
+		if (point.fitness <= target) return static_cast<double>(point.call);
+
+	return std::numeric_limits<double>::quiet_NaN();
+}
+
+double Expected_Running_Time(const std::vector<std::vector<TConvergence_Point>> &traces, const double target) {
+	double spent_calls = 0.0;
+	size_t successes = 0;
+	for (const auto &trace : traces) {
+		if (trace.empty()) continue;
+
+		const double calls = Calls_To_Target(trace, target);
+		if (!std::isnan(calls)) {
+			spent_calls += calls;
+			successes++;
+		} else
+			spent_calls += static_cast<double>(trace.back().call);
+	}
+
+	return successes > 0 ? spent_calls / static_cast<double>(successes) : std::numeric_limits<double>::infinity();
+}
+
+double Empirical_Distribution(const std::vector<std::vector<TConvergence_Point>> &traces, const std::vector<double> &targets, const double calls) {
+	size_t pairs = 0, reached = 0;
+	for (const auto &trace : traces) {
+		if (trace.empty()) continue;
+
+		for (const double target : targets) {
+			pairs++;
+			const double needed = Calls_To_Target(trace, target);
+			if (!std::isnan(needed) && (needed <= calls)) reached++;
+		}
+	}
+
+	return pairs > 0 ? static_cast<double>(reached) / static_cast<double>(pairs) : std::numeric_limits<double>::quiet_NaN();
+}
+
+void CAnytime_Report_Sink::End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) {
+	const auto ert_targets = Anytime_Targets(1);
+	const auto ecdf_targets = Anytime_Targets(5);	//51 targets as COCO uses
+
+	double max_calls = 0.0;
+	for (const auto &result : results)
+		for (const auto &trace : result.convergence)
+			if (!trace.empty() && (static_cast<double>(trace.back().call) > max_calls)) max_calls = static_cast<double>(trace.back().call);
+
+	if (max_calls == 0.0) return;	//e.g., the distributed solver evaluates remotely and has no traces
+
+	std::vector<double> budgets;	//two per decade
+	for (double exponent = 0.0; std::pow(10.0, exponent) < max_calls * std::sqrt(10.0); exponent += 0.5)
+		budgets.push_back(std::floor(std::pow(10.0, exponent)));
+
+	std::cout << std::endl << "Anytime performance of " << problem.name << ", problem size = " << problem.size << std::endl;
+	std::cout.precision(3);
+	std::cout << std::scientific;
+
+	std::cout << "ERT [calls] to fitness error target";
+	for (const double target : ert_targets)
+		std::cout << "; " << target;
+	std::cout << std::endl;
+
+	for (const auto &result : results) {
+		if (result.convergence.empty()) continue;
+
+		std::wcout << result.name;
+		for (const double target : ert_targets)
+			std::cout << "; " << Expected_Running_Time(result.convergence, target);
+		std::cout << std::endl;
+	}
+
+	std::cout << std::endl << "ECDF [solved targets] within calls";
+	for (const double budget : budgets)
+		std::cout << "; " << budget;
+	std::cout << std::endl;
+
+	for (const auto &result : results) {
+		if (result.convergence.empty()) continue;
+
+		std::wcout << result.name;
+		for (const double budget : budgets)
+			std::cout << "; " << Empirical_Distribution(result.convergence, ecdf_targets, budget);
+		std::cout << std::endl;
+	}
+
+	std::cout << std::endl;
+}
@@ -0,0 +1,61 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "result_sink.h"
+
+//COCO-style anytime performance of the solvers, calculated from the convergence traces
+//targets are the fitness errors, i.e., |fitness - optimum_fitness|
+
+std::vector<double> Anytime_Targets(const size_t per_decade);	//1e2 down to 1e-8
+
+//number of objective calls needed to reach the target, or NaN if the run did not reach it
+double Calls_To_Target(const std::vector<TConvergence_Point> &trace, const double target);
+
+//expected running time - all calls spent by the runs, until they reached the target or ended, divided by the number of successful runs
+double Expected_Running_Time(const std::vector<std::vector<TConvergence_Point>> &traces, const double target);
+
+//fraction of the (run, target) pairs, which were reached within the given number of calls
+double Empirical_Distribution(const std::vector<std::vector<TConvergence_Point>> &traces, const std::vector<double> &targets, const double calls);
+
+//prints ERT and ECDF tables, once a problem is evaluated
+class CAnytime_Report_Sink : public IResult_Sink {
+public:
+	virtual void End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) override;
+};
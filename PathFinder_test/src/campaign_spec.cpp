@@ -0,0 +1,190 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "campaign_spec.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+namespace {
+	std::string Trim(const std::string &str) {
+		const auto first = str.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos) return std::string{};
+		const auto last = str.find_last_not_of(" \t\r\n");
+		return str.substr(first, last - first + 1);
+	}
+
+	std::vector<std::string> Split_List(const std::string &value) {
+		std::vector<std::string> items;
+		std::istringstream stream{ value };
+		std::string item;
+		while (std::getline(stream, item, ',')) {
+			item = Trim(item);
+			if (!item.empty()) items.push_back(item);
+		}
+		return items;
+	}
+
+	bool Parse_Size(const std::string &str, size_t &value) {
+		if (str.empty() || !isdigit(static_cast<unsigned char>(str[0]))) return false;
+		char *end = nullptr;
+		value = static_cast<size_t>(std::strtoull(str.c_str(), &end, 10));
+		return *end == 0;
+	}
+
+	bool Parse_Double(const std::string &str, double &value) {
+		char *end = nullptr;
+		value = std::strtod(str.c_str(), &end);
+		return !str.empty() && (*end == 0);
+	}
+
+	bool Parse_Size_List(const std::string &value, std::vector<size_t> &sizes) {
+		sizes.clear();
+		for (const auto &item : Split_List(value)) {
+			size_t size;
+			if (!Parse_Size(item, size)) return false;
+			sizes.push_back(size);
+		}
+		return !sizes.empty();
+	}
+}
+
+bool TCampaign_Spec::Selects_Problem(const size_t ordinal, const std::string &name) const {
+	if (problems.empty()) return true;
+
+	for (const auto &problem : problems) {
+		if (problem == name) return true;
+
+		size_t low, high;
+		const auto dash = problem.find('-');
+		if (dash == std::string::npos) {
+			if (Parse_Size(problem, low) && (low == ordinal)) return true;
+		}
+		else if (Parse_Size(problem.substr(0, dash), low) && Parse_Size(problem.substr(dash + 1), high) && (low <= ordinal) && (ordinal <= high))
+			return true;
+	}
+
+	return false;
+}
+
+std::vector<size_t> TCampaign_Spec::Selected_Problems(const std::vector<std::string> &names) const {
+	std::vector<size_t> ordinals;
+	for (size_t ordinal = 0; ordinal < names.size(); ordinal++)
+		if (Selects_Problem(ordinal, names[ordinal])) ordinals.push_back(ordinal);
+
+	if (ordinals.empty() && !strict_problems) {
+		std::cout << "problem_ordinal_number out of bounds, ignoring it..." << std::endl;
+		for (size_t ordinal = 0; ordinal < names.size(); ordinal++)
+			ordinals.push_back(ordinal);
+	}
+
+	return ordinals;
+}
+
+bool Load_Campaign_Spec(const std::string &file_name, TCampaign_Spec &spec, TCampaign_Options &options, std::string &error) {
+	std::ifstream file{ file_name };
+	if (!file.is_open()) {
+		error = "cannot open " + file_name;
+		return false;
+	}
+
+	std::string line;
+	size_t line_number = 0;
+	while (std::getline(file, line)) {
+		line_number++;
+		line = Trim(line.substr(0, line.find('#')));
+		if (line.empty()) continue;
+
+		const auto equals = line.find('=');
+		const std::string key = Trim(line.substr(0, equals));
+		const std::string value = equals != std::string::npos ? Trim(line.substr(equals + 1)) : std::string{};
+
+		bool ok = true;
+		if (value.empty()) ok = false;
+		else if (key == "problem_sizes") ok = Parse_Size_List(value, spec.problem_sizes);
+		else if (key == "problems") {
+			spec.problems = Split_List(value);
+			spec.strict_problems = true;
+		}
+		else if (key == "repetitions") ok = Parse_Size(value, spec.repetitions);
+		else if (key == "population_sizes") ok = Parse_Size_List(value, options.population_sizes);
+		else if (key == "max_generations") ok = Parse_Size(value, options.max_generations);
+		else if (key == "randomize") options.randomize_optimum = (value == "true") || (value == "1");
+		else if (key == "budget_seconds") ok = Parse_Double(value, options.budget.seconds);
+		else if (key == "budget_evaluations") {
+			size_t evaluations;
+			ok = Parse_Size(value, evaluations);
+			options.budget.evaluations = evaluations;
+		}
+		else if (key == "target_epsilon") ok = Parse_Double(value, options.budget.target_epsilon);
+		else if (key == "solvers") {
+			options.solvers.clear();
+			for (const auto &solver : Split_List(value))
+				options.solvers.push_back(Widen_String(solver));
+			ok = !options.solvers.empty();
+		}
+		else {
+			error = file_name + ":" + std::to_string(line_number) + ": unknown key " + key;
+			return false;
+		}
+
+		if (!ok) {
+			error = file_name + ":" + std::to_string(line_number) + ": invalid value of " + key;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Parse_Shard(const std::string &text, TCampaign_Options &options) {
+	const auto slash = text.find('/');
+	if (slash == std::string::npos) return false;
+
+	size_t index, count;
+	if (!Parse_Size(text.substr(0, slash), index) || !Parse_Size(text.substr(slash + 1), count)) return false;
+	if ((count == 0) || (index >= count)) return false;
+
+	options.shard_index = index;
+	options.shard_count = count;
+	return true;
+}
@@ -0,0 +1,73 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "solvers.h"
+
+#include <string>
+#include <vector>
+
+//A declarative campaign, i.e., the grid of the cells to run.
+//The spec file consists of "key = value" lines, lists are comma separated, '#' starts a comment:
+//
+//	problem_sizes = 3, 10, 30
+//	problems = 0, 2-4, sphere			#ordinal numbers, their ranges or names; all problems if omitted
+//	solvers = {787223E7-6363-41D0-B13D-93B5D4D94BBD}, NewUOA	#GUIDs or descriptions
+//	population_sizes = 15, 100
+//	max_generations = 100000
+//	repetitions = 10
+//	randomize = true
+//	budget_seconds = 600
+//	budget_evaluations = 1000000
+//	target_epsilon = 1e-8
+struct TCampaign_Spec {
+	std::vector<size_t> problem_sizes;
+	std::vector<std::string> problems;	//empty - all problems
+	bool strict_problems = false;	//set by the spec file, whose problems must select some problem, while the command line's ordinal falls back to all of them
+	size_t repetitions = 1;
+
+	bool Selects_Problem(const size_t ordinal, const std::string &name) const;
+	std::vector<size_t> Selected_Problems(const std::vector<std::string> &names) const;	//ordinal numbers of the selected problems of a collection, all of them if none is selected, unless strict_problems
+};
+
+//the solver related keys go to options; returns false and describes the error, if the file cannot be read or has an invalid line
+bool Load_Campaign_Spec(const std::string &file_name, TCampaign_Spec &spec, TCampaign_Options &options, std::string &error);
+
+//parses "i/N", i in [0, N)
+bool Parse_Shard(const std::string &text, TCampaign_Options &options);
@@ -0,0 +1,175 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "fitness_cache.h"
+
+#include <cstring>
+
+namespace {
+	constexpr size_t Max_Shard_Count = 16;
+
+	uint64_t Mix(uint64_t value) {
+		//splitmix64 finalizer
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ULL;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	}
+}
+
+CFitness_Cache::CFitness_Cache(const size_t problem_size, const size_t capacity) : mProblem_Size(problem_size) {
+	const size_t shard_count = capacity < Max_Shard_Count ? (capacity > 0 ? capacity : 1) : Max_Shard_Count;
+	const size_t slots_per_shard = capacity > shard_count ? (capacity + shard_count - 1) / shard_count : 1;
+
+	size_t index_size = 1;
+	while (index_size < 2 * slots_per_shard) index_size <<= 1;	//load factor of the index stays below 1/2
+
+	for (size_t i = 0; i < shard_count; i++) {
+		auto shard = std::make_unique<TShard>();
+		shard->slot_count = slots_per_shard;
+		shard->solutions.resize(slots_per_shard * problem_size);
+		shard->fitness.resize(slots_per_shard);
+		shard->hashes.resize(slots_per_shard);
+		shard->referenced.resize(slots_per_shard);
+		shard->index.assign(index_size, 0);
+		shard->index_mask = index_size - 1;
+		mShards.push_back(std::move(shard));
+	}
+}
+
+CFitness_Cache::TShard& CFitness_Cache::Shard(const uint64_t hash) {
+	//the low bits address the shard's index, thus the high bits select the shard
+	return *mShards[static_cast<size_t>(hash >> 48) % mShards.size()];
+}
+
+uint64_t CFitness_Cache::Hash(const double *solution) const {
+	uint64_t hash = Mix(0x9e3779b97f4a7c15ULL);
+	for (size_t i = 0; i < mProblem_Size; i++) {
+		uint64_t bits;
+		std::memcpy(&bits, solution + i, sizeof(bits));
+		hash = Mix(hash ^ bits);
+	}
+
+	return hash;
+}
+
+bool CFitness_Cache::Find(TShard &shard, const double *solution, const uint64_t hash, size_t &slot) const {
+	for (size_t pos = static_cast<size_t>(hash) & shard.index_mask; shard.index[pos] != 0; pos = (pos + 1) & shard.index_mask) {
+		const size_t candidate = shard.index[pos] - 1;
+		if ((shard.hashes[candidate] == hash) &&
+			(std::memcmp(shard.solutions.data() + candidate * mProblem_Size, solution, mProblem_Size * sizeof(double)) == 0)) {
+			slot = candidate;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CFitness_Cache::Remove_From_Index(TShard &shard, const size_t slot) {
+	size_t hole = static_cast<size_t>(shard.hashes[slot]) & shard.index_mask;
+	while (shard.index[hole] != slot + 1)
+		hole = (hole + 1) & shard.index_mask;
+
+	//backward shift deletion, i.e., no tombstones
+	for (size_t next = (hole + 1) & shard.index_mask; shard.index[next] != 0; next = (next + 1) & shard.index_mask) {
+		const size_t ideal = static_cast<size_t>(shard.hashes[shard.index[next] - 1]) & shard.index_mask;
+		if (((next - ideal) & shard.index_mask) >= ((next - hole) & shard.index_mask)) {
+			shard.index[hole] = shard.index[next];
+			hole = next;
+		}
+	}
+
+	shard.index[hole] = 0;
+}
+
+bool CFitness_Cache::Lookup(const double *solution, const uint64_t hash, double &fitness) {
+	TShard &shard = Shard(hash);
+	std::lock_guard<std::mutex> lock{ shard.lock };
+
+	size_t slot;
+	if (!Find(shard, solution, hash, slot)) {
+		mMisses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	shard.referenced[slot] = 1;
+	fitness = shard.fitness[slot];
+	mHits.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void CFitness_Cache::Insert(const double *solution, const uint64_t hash, const double fitness) {
+	TShard &shard = Shard(hash);
+	std::lock_guard<std::mutex> lock{ shard.lock };
+
+	size_t slot;
+	if (Find(shard, solution, hash, slot)) return;	//another thread has evaluated the same solution meanwhile
+
+	if (shard.used < shard.slot_count)
+		slot = shard.used++;
+	else {
+		while (shard.referenced[shard.hand]) {
+			shard.referenced[shard.hand] = 0;
+			shard.hand = (shard.hand + 1) % shard.slot_count;
+		}
+
+		slot = shard.hand;
+		shard.hand = (shard.hand + 1) % shard.slot_count;
+		Remove_From_Index(shard, slot);
+	}
+
+	std::memcpy(shard.solutions.data() + slot * mProblem_Size, solution, mProblem_Size * sizeof(double));
+	shard.fitness[slot] = fitness;
+	shard.hashes[slot] = hash;
+	shard.referenced[slot] = 0;
+
+	size_t pos = static_cast<size_t>(hash) & shard.index_mask;
+	while (shard.index[pos] != 0)
+		pos = (pos + 1) & shard.index_mask;
+	shard.index[pos] = static_cast<uint32_t>(slot + 1);
+}
+
+uint64_t CFitness_Cache::Hits() const {
+	return mHits.load(std::memory_order_relaxed);
+}
+
+uint64_t CFitness_Cache::Misses() const {
+	return mMisses.load(std::memory_order_relaxed);
+}
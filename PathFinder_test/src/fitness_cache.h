@@ -0,0 +1,84 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Bounded memoization of the objective for deterministic problems, keyed by the exact bit pattern of the solution.
+//The entries are split to independently locked shards; each shard evicts by the CLOCK policy and allocates nothing after construction.
+//A cache serves a single problem instance only, thus each run creates its own, see Run_Solver.
+class CFitness_Cache {
+protected:
+	struct TShard {
+		std::mutex lock;
+		size_t slot_count = 0;
+		size_t used = 0;
+		size_t hand = 0;	//CLOCK hand
+
+		std::vector<double> solutions;	//slot_count * problem_size
+		std::vector<double> fitness;
+		std::vector<uint64_t> hashes;
+		std::vector<uint8_t> referenced;
+
+		std::vector<uint32_t> index;	//open addressing by the hash, slot + 1, 0 is empty
+		size_t index_mask = 0;
+	};
+
+	const size_t mProblem_Size;
+	std::vector<std::unique_ptr<TShard>> mShards;
+
+	std::atomic<uint64_t> mHits{ 0 }, mMisses{ 0 };
+
+	TShard& Shard(const uint64_t hash);
+	bool Find(TShard &shard, const double *solution, const uint64_t hash, size_t &slot) const;
+	void Remove_From_Index(TShard &shard, const size_t slot);
+public:
+	CFitness_Cache(const size_t problem_size, const size_t capacity);
+
+	uint64_t Hash(const double *solution) const;
+	bool Lookup(const double *solution, const uint64_t hash, double &fitness);	//counts a hit or a miss
+	void Insert(const double *solution, const uint64_t hash, const double fitness);
+
+	uint64_t Hits() const;
+	uint64_t Misses() const;
+};
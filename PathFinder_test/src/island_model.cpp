@@ -0,0 +1,238 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "island_model.h"
+#include "run_budget.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+	struct TIsland {
+		GUID solver = Invalid_GUID;
+		solver::TSolver_Progress progress{ 0 };	//of the current epoch, its solver's own; Solve_Islands only cancels it, see Cancel_Solver
+		std::atomic<size_t> generations{ 0 };	//of the completed epochs, i.e., the progress reported by Solve_Islands
+		bool succeeded = false;
+
+		//the emigrant, i.e., the island's best so far
+		std::mutex lock;
+		std::vector<double> best;
+		double best_fitness = std::numeric_limits<double>::infinity();
+	};
+
+	struct TArchipelago {
+		std::vector<std::unique_ptr<TIsland>> islands;
+		std::mutex lock;
+		std::condition_variable finished_signal;
+		size_t finished = 0;
+	};
+
+	//appends the latest emigrants of the island's neighbours
+	void Take_Immigrants(TArchipelago &archipelago, const size_t index, const NMigration_Topology topology, std::vector<std::vector<double>> &hints) {
+		const size_t count = archipelago.islands.size();
+		auto immigrate = [&](const size_t from) {
+			TIsland &neighbour = *archipelago.islands[from];
+			std::lock_guard<std::mutex> lock{ neighbour.lock };
+			if (!neighbour.best.empty()) hints.push_back(neighbour.best);
+		};
+
+		if (count < 2) return;
+		if (topology == NMigration_Topology::Ring)
+			immigrate((index + count - 1) % count);
+		else {
+			for (size_t i = 0; i < count; i++)
+				if (i != index) immigrate(i);
+		}
+	}
+
+	void Run_Island(TArchipelago &archipelago, const size_t index, const solver::TSolver_Setup &setup, const TIsland_Setup &island_setup) {
+		TIsland &island = *archipelago.islands[index];
+		const size_t problem_size = setup.problem_size;
+		std::vector<double> solution(problem_size), own;
+		double own_fitness = std::numeric_limits<double>::infinity();
+		std::vector<std::vector<double>> hints;
+		std::vector<const double*> hint_pointers;
+
+		std::mt19937_64 random_generator{ 0x9e3779b97f4a7c15ull * (index + 1) };
+		const size_t interval = island_setup.migration_interval > 0 ? island_setup.migration_interval : setup.max_generations;
+
+		try {
+			for (size_t generations = 0; (generations < setup.max_generations) && !Is_Solver_Cancelled(island.progress); ) {
+				const size_t epoch = setup.max_generations - generations < interval ? setup.max_generations - generations : interval;
+
+				hints.clear();
+				if (generations == 0) {
+					for (size_t i = 0; i < setup.hint_count; i++)
+						hints.emplace_back(setup.hints[i], setup.hints[i] + problem_size);
+
+					std::vector<double> random_hint(problem_size);
+					for (size_t d = 0; d < problem_size; d++)
+						random_hint[d] = std::uniform_real_distribution<double>{ setup.lower_bound[d], setup.upper_bound[d] }(random_generator);
+					hints.push_back(std::move(random_hint));
+				}
+				else {
+					hints.push_back(own);
+					Take_Immigrants(archipelago, index, island_setup.topology, hints);
+				}
+
+				hint_pointers.clear();
+				for (const auto &hint : hints)
+					hint_pointers.push_back(hint.data());
+
+				solver::TSolver_Setup epoch_setup{ problem_size, setup.objectives_count,
+									setup.lower_bound, setup.upper_bound,
+									hint_pointers.data(), hint_pointers.size(),
+									solution.data(),
+									setup.data, setup.objective, setup.constraints,
+									epoch, setup.population_size, setup.tolerance,
+				};
+
+				island.progress.current_progress = 0;
+				island.progress.best_metric[0] = std::numeric_limits<double>::quiet_NaN();
+				if (solver::Solve_Generic(island.solver, epoch_setup, island.progress) != S_OK) break;
+				island.generations += island.progress.current_progress;
+				generations += epoch;
+
+				//the solver's best metric is the solution's fitness; if it does not report it, it costs an objective call
+				double fitness = island.progress.best_metric[0];
+				if (std::isnan(fitness) && !setup.objective(setup.data, 1, solution.data(), &fitness)) break;
+
+				island.succeeded = true;
+				const bool improved = own.empty() || (fitness < own_fitness);
+				if (improved) {
+					own = solution;
+					own_fitness = fitness;
+
+					std::lock_guard<std::mutex> lock{ island.lock };
+					island.best = own;
+					island.best_fitness = own_fitness;
+				}
+
+				//the solver converged before the epoch's end and the immigrants did not help, further epochs would only restart it
+				if (!improved && (island.progress.current_progress < epoch)) break;
+			}
+		}
+		catch (...) {}	//the island fails, the others go on
+
+		std::lock_guard<std::mutex> lock{ archipelago.lock };
+		archipelago.finished++;
+		archipelago.finished_signal.notify_all();
+	}
+}
+
+bool Parse_Migration_Topology(const std::string &text, NMigration_Topology &topology) {
+	if (text == "ring") topology = NMigration_Topology::Ring;
+	else if (text == "full") topology = NMigration_Topology::Fully_Connected;
+	else return false;
+
+	return true;
+}
+
+scgms::TSolver_Descriptor Island_Model_Descriptor() {
+	return scgms::TSolver_Descriptor{ diagnostic::island_model::id, diagnostic::island_model::description, FALSE, 0, nullptr };
+}
+
+HRESULT Solve_Islands(const solver::TSolver_Setup &setup, solver::TSolver_Progress &progress, const TIsland_Setup &island_setup) {
+	if (island_setup.solvers.empty()) return E_INVALIDARG;
+
+	size_t island_count = island_setup.islands;
+	if (island_count == 0) {
+		island_count = std::thread::hardware_concurrency();
+		if (island_count < island_setup.solvers.size()) island_count = island_setup.solvers.size();
+	}
+
+	TArchipelago archipelago;
+	for (size_t i = 0; i < island_count; i++) {
+		archipelago.islands.push_back(std::make_unique<TIsland>());
+		archipelago.islands.back()->solver = island_setup.solvers[i % island_setup.solvers.size()];
+	}
+
+	progress.max_progress = setup.max_generations * island_count;
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < island_count; i++)
+		threads.emplace_back(Run_Island, std::ref(archipelago), i, std::cref(setup), std::cref(island_setup));
+
+	//forwards the cancellation, e.g., by the run's budget, and reports the islands' completed epochs until all of them finish
+	bool cancelled = false;
+	for (bool all_finished = false; !all_finished; ) {
+		{
+			std::unique_lock<std::mutex> lock{ archipelago.lock };
+			archipelago.finished_signal.wait_for(lock, std::chrono::milliseconds(10), [&archipelago, island_count] { return archipelago.finished == island_count; });
+			all_finished = archipelago.finished == island_count;
+		}
+
+		const bool cancel = !cancelled && Is_Solver_Cancelled(progress);
+		cancelled |= cancel;
+
+		size_t current_progress = 0;
+		double best_fitness = std::numeric_limits<double>::infinity();
+		for (auto &island : archipelago.islands) {
+			if (cancel) Cancel_Solver(island->progress);
+			current_progress += island->generations;
+
+			std::lock_guard<std::mutex> lock{ island->lock };
+			if (island->best_fitness < best_fitness) best_fitness = island->best_fitness;
+		}
+		progress.current_progress = current_progress;
+		if (std::isfinite(best_fitness)) progress.best_metric[0] = best_fitness;
+	}
+
+	for (auto &thread : threads)
+		thread.join();
+
+	bool succeeded = false;
+	const TIsland *best = nullptr;
+	for (const auto &island : archipelago.islands) {
+		succeeded |= island->succeeded;
+		if (!island->best.empty() && (!best || (island->best_fitness < best->best_fitness))) best = island.get();
+	}
+	if (!succeeded || !best) return E_FAIL;
+
+	for (size_t d = 0; d < setup.problem_size; d++)
+		setup.solution[d] = best->best[d];
+
+	return S_OK;
+}
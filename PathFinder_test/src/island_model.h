@@ -0,0 +1,74 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <scgms/rtl/SolverLib.h>
+#include <scgms/rtl/UILib.h>
+
+#include <string>
+#include <vector>
+
+namespace diagnostic {
+	namespace island_model {
+		constexpr GUID id = { 0x5a3c2e17, 0x9b4d, 0x4f61, { 0x8e, 0x2a, 0x7c, 0x1d, 0x0b, 0x93, 0xf4, 0xa6 } };	// {5A3C2E17-9B4D-4F61-8E2A-7C1D0B93F4A6}
+		constexpr const wchar_t* description = L"Island model";
+	}
+}
+
+enum class NMigration_Topology {
+	Ring = 0,	//an island receives from its predecessor
+	Fully_Connected	//an island receives from all the others
+};
+
+bool Parse_Migration_Topology(const std::string &text, NMigration_Topology &topology);	//ring, full
+
+struct TIsland_Setup {
+	std::vector<GUID> solvers;	//of the islands, round-robin; the meta-solver itself and the distributed solver are not allowed
+	size_t islands = 0;	//0 - a thread per hardware thread, at least the number of the solvers
+	size_t migration_interval = 100;	//generations of an epoch, after which an island emigrates its best and takes the immigrants as hints
+	NMigration_Topology topology = NMigration_Topology::Ring;
+};
+
+//the meta-solver as a selectable solver, e.g., by its description in a campaign
+scgms::TSolver_Descriptor Island_Model_Descriptor();
+
+//Runs the islands on their own threads in epochs of migration_interval generations, up to setup.max_generations each.
+//After an epoch, an island publishes its best and starts the next epoch from it and its neighbours' latest bests, without waiting for them.
+//The islands share setup's objective, which must be thread-safe. Succeeds, if any island does.
+HRESULT Solve_Islands(const solver::TSolver_Setup &setup, solver::TSolver_Progress &progress, const TIsland_Setup &islands);
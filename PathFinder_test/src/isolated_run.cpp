@@ -0,0 +1,462 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "isolated_run.h"
+#include "result_store.h"
+
+#include <chrono>
+#include <iostream>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <cerrno>
+	#include <cstring>
+	#include <cstdlib>
+	#include <csignal>
+	#include <map>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <sys/resource.h>
+	#include <sys/socket.h>
+	#include <sys/wait.h>
+#endif
+
+#ifdef _WIN32
+
+bool Run_Isolated(const std::function<void(TRun_Record &record)> &run, TRun_Record &record, const TIsolation_Limits &limits, std::string &failure) {
+	try {
+		run(record);
+	}
+	catch (...) {
+		failure = "exception";
+		return false;
+	}
+
+	return true;
+}
+
+CIsolation_Server::~CIsolation_Server() {
+	Stop();
+}
+
+bool CIsolation_Server::Start(const std::function<void(const size_t index, TRun_Record &record)> &run, const TIsolation_Limits &limits) {
+	mRun = run;
+	mLimits = limits;
+	return true;
+}
+
+bool CIsolation_Server::Run(const size_t index, TRun_Record &record, std::string &failure) {
+	return Run_Isolated([this, index](TRun_Record &isolated_record) { mRun(index, isolated_record); }, record, mLimits, failure);
+}
+
+void CIsolation_Server::Stop() {
+}
+
+#else
+
+namespace {
+	void Apply_Limits(const TIsolation_Limits &limits) {
+		if (limits.cpu_seconds > 0.0) {
+			const rlim_t seconds = static_cast<rlim_t>(limits.cpu_seconds + 0.999);
+			const rlimit cpu{ seconds, seconds + 1 };	//SIGXCPU first, SIGKILL a second later
+			setrlimit(RLIMIT_CPU, &cpu);
+		}
+
+		if (limits.memory_mb > 0) {
+			const rlim_t bytes = static_cast<rlim_t>(limits.memory_mb) * 1024 * 1024;
+			const rlimit memory{ bytes, bytes };
+			setrlimit(RLIMIT_AS, &memory);
+		}
+	}
+
+	bool Write_All(const int fd, const std::string &data) {
+		size_t written = 0;
+		while (written < data.size()) {
+			const ssize_t rc = write(fd, data.data() + written, data.size() - written);
+			if (rc < 0) {
+				if (errno == EINTR) continue;
+				return false;
+			}
+			written += static_cast<size_t>(rc);
+		}
+		return true;
+	}
+
+	std::string Describe_Status(const int status) {
+		if (WIFSIGNALED(status)) {
+			const int signal_number = WTERMSIG(status);
+			if (signal_number == SIGXCPU) return "CPU time limit exceeded";
+			return std::string{ "killed by signal " } + std::to_string(signal_number) + " (" + strsignal(signal_number) + ")";
+		}
+
+		if (WIFEXITED(status)) return "exited with code " + std::to_string(WEXITSTATUS(status));
+		return "unknown status " + std::to_string(status);
+	}
+
+	//the child's side of an isolated run; it leaves by _exit, so that it flushes nothing of what the parent has buffered
+	[[noreturn]] void Run_Child(const int fd, const std::function<void(TRun_Record &record)> &run, TRun_Record &record, const TIsolation_Limits &limits) {
+		Apply_Limits(limits);
+
+		int exit_code = 0;
+		try {
+			run(record);
+			if (!Write_All(fd, Serialize_Run_Record(record) + "\n")) exit_code = 3;
+		}
+		catch (...) {
+			exit_code = 2;
+		}
+
+		std::cout.flush();
+		std::wcout.flush();
+		close(fd);
+		_exit(exit_code);
+	}
+
+	//what the child, and the isolation server on its behalf, have written to the pipe, line by line
+	struct TChild_Output {
+		pid_t pid = -1;			//pid=, by a child of the server
+		bool has_status = false;	//status=, the child's wait status, by the server
+		int status = 0;
+		std::string error;		//error=, by the server, which could not start the child
+		std::string record;		//the serialized record, by the child
+	};
+
+	TChild_Output Parse_Output(const std::string &output) {
+		TChild_Output child;
+		size_t begin = 0;
+		while (begin < output.size()) {
+			size_t end = output.find('\n', begin);
+			if (end == std::string::npos) end = output.size();
+			std::string line = output.substr(begin, end - begin);
+			begin = end + 1;
+			if (!line.empty() && (line.back() == '\r')) line.pop_back();
+
+			if (line.compare(0, 4, "pid=") == 0) child.pid = static_cast<pid_t>(std::atoi(line.c_str() + 4));
+			else if (line.compare(0, 7, "status=") == 0) {
+				child.has_status = true;
+				child.status = std::atoi(line.c_str() + 7);
+			}
+			else if (line.compare(0, 6, "error=") == 0) child.error = line.substr(6);
+			else if (!line.empty()) child.record = line;
+		}
+
+		return child;
+	}
+
+	//reads the pipe until its writers close it; once the wall-clock limit expires, the child is killed and given a grace period to close it
+	//returns false on the timeout; pid is the child's one, or -1, if it is to be told by the output
+	bool Read_Output(const int fd, pid_t pid, const double wall_seconds, std::string &output) {
+		constexpr double Kill_Grace_Seconds = 5.0;
+
+		const auto start = std::chrono::steady_clock::now();
+		bool timed_out = false;
+		char buffer[4096];
+		for (;;) {
+			int timeout_ms = -1;
+			if (wall_seconds > 0.0) {
+				const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+				const double remaining = wall_seconds + (timed_out ? Kill_Grace_Seconds : 0.0) - elapsed.count();
+				if (remaining <= 0.0) {
+					if (timed_out) break;	//gives up the pipe
+
+					timed_out = true;
+					if (pid < 0) pid = Parse_Output(output).pid;
+					if (pid > 0) kill(pid, SIGKILL);
+					continue;
+				}
+				timeout_ms = static_cast<int>(remaining * 1000.0) + 1;
+			}
+
+			pollfd descriptor{ fd, POLLIN, 0 };
+			const int ready = poll(&descriptor, 1, timeout_ms);
+			if (ready < 0) {
+				if (errno == EINTR) continue;
+				break;
+			}
+			if (ready == 0) continue;	//re-evaluates the remaining time
+
+			const ssize_t count = read(fd, buffer, sizeof(buffer));
+			if (count < 0) {
+				if (errno == EINTR) continue;
+				break;
+			}
+			if (count == 0) break;	//EOF
+			output.append(buffer, static_cast<size_t>(count));
+		}
+
+		return !timed_out;
+	}
+
+	bool Complete_Run(const int status, const std::string &line, TRun_Record &record, std::string &failure) {
+		if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) {
+			failure = Describe_Status(status);
+			return false;
+		}
+
+		TRun_Record completed;
+		if (!Deserialize_Run_Record(line, completed)) {
+			failure = "corrupted result";
+			return false;
+		}
+
+		record = std::move(completed);
+		return true;
+	}
+
+	//a request is a single message, the run's index, with the write end of the run's result pipe attached
+	bool Send_Request(const int socket, size_t index, const int fd) {
+		iovec data{ &index, sizeof(index) };
+		char control[CMSG_SPACE(sizeof(int))] = {};
+		msghdr message{};
+		message.msg_iov = &data;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		cmsghdr *header = CMSG_FIRSTHDR(&message);
+		header->cmsg_level = SOL_SOCKET;
+		header->cmsg_type = SCM_RIGHTS;
+		header->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(header), &fd, sizeof(int));
+
+		ssize_t rc;
+		while (((rc = sendmsg(socket, &message, MSG_NOSIGNAL)) < 0) && (errno == EINTR));
+		return rc == static_cast<ssize_t>(sizeof(index));
+	}
+
+	bool Receive_Request(const int socket, size_t &index, int &fd) {
+		iovec data{ &index, sizeof(index) };
+		char control[CMSG_SPACE(sizeof(int))] = {};
+		msghdr message{};
+		message.msg_iov = &data;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		ssize_t rc;
+		while (((rc = recvmsg(socket, &message, 0)) < 0) && (errno == EINTR));
+		if (rc != static_cast<ssize_t>(sizeof(index))) return false;	//0 - the campaign has stopped the server, or it has gone
+
+		const cmsghdr *header = CMSG_FIRSTHDR(&message);
+		if (!header || (header->cmsg_level != SOL_SOCKET) || (header->cmsg_type != SCM_RIGHTS)) return false;
+		memcpy(&fd, CMSG_DATA(header), sizeof(int));
+		return true;
+	}
+
+	void Serve(const int socket, const std::function<void(const size_t index, TRun_Record &record)> &run, const TIsolation_Limits &limits) {
+		constexpr int Reap_Period_ms = 5;
+
+		signal(SIGPIPE, SIG_IGN);	//a result pipe, which the campaign has given up, must not kill the server
+		std::map<pid_t, int> runs;	//the children and the write ends of their result pipes
+		for (;;) {
+			pollfd descriptor{ socket, POLLIN, 0 };
+			const int ready = poll(&descriptor, 1, runs.empty() ? -1 : Reap_Period_ms);
+
+			int status = 0;
+			for (pid_t pid; (pid = waitpid(-1, &status, WNOHANG)) > 0; ) {
+				const auto child = runs.find(pid);
+				if (child == runs.end()) continue;
+
+				Write_All(child->second, "status=" + std::to_string(status) + "\n");
+				close(child->second);
+				runs.erase(child);
+			}
+
+			if (ready <= 0) continue;
+
+			size_t index = 0;
+			int fd = -1;
+			if (!Receive_Request(socket, index, fd)) break;
+
+			const pid_t pid = fork();
+			if (pid == 0) {
+				signal(SIGPIPE, SIG_DFL);
+				close(socket);
+				for (const auto &child : runs)	//otherwise, the other runs' pipes would not close until this one exits
+					close(child.second);
+
+				Write_All(fd, "pid=" + std::to_string(getpid()) + "\n");
+				TRun_Record record;
+				Run_Child(fd, [&run, index](TRun_Record &child_record) { run(index, child_record); }, record, limits);
+			}
+
+			if (pid < 0) {
+				Write_All(fd, "error=cannot fork\n");
+				close(fd);
+			}
+			else
+				runs[pid] = fd;
+		}
+
+		//the campaign has stopped the server, or it has gone, so do the runs
+		for (const auto &child : runs) {
+			kill(child.first, SIGKILL);
+			close(child.second);
+		}
+		while ((wait(nullptr) > 0) || (errno == EINTR));
+	}
+}
+
+bool Run_Isolated(const std::function<void(TRun_Record &record)> &run, TRun_Record &record, const TIsolation_Limits &limits, std::string &failure) {
+	int fds[2];
+	if (pipe(fds) != 0) {
+		failure = "cannot create a pipe";
+		return false;
+	}
+
+	//the child never flushes what the parent has buffered, it leaves by _exit
+	std::cout.flush();
+	std::wcout.flush();
+
+	const pid_t pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		failure = "cannot fork";
+		return false;
+	}
+
+	if (pid == 0) {
+		close(fds[0]);
+		Run_Child(fds[1], run, record, limits);
+	}
+
+	close(fds[1]);
+
+	std::string output;
+	const bool timed_out = !Read_Output(fds[0], pid, limits.wall_seconds, output);
+	close(fds[0]);
+
+	int status = 0;
+	while ((waitpid(pid, &status, 0) < 0) && (errno == EINTR));
+
+	if (timed_out) {
+		failure = "wall-clock limit exceeded";
+		return false;
+	}
+
+	return Complete_Run(status, Parse_Output(output).record, record, failure);
+}
+
+CIsolation_Server::~CIsolation_Server() {
+	Stop();
+}
+
+bool CIsolation_Server::Start(const std::function<void(const size_t index, TRun_Record &record)> &run, const TIsolation_Limits &limits) {
+	Stop();
+	mRun = run;
+	mLimits = limits;
+
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) return false;	//keeps the requests apart
+
+	std::cout.flush();
+	std::wcout.flush();
+
+	const pid_t pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+
+	if (pid == 0) {
+		close(fds[0]);
+		Serve(fds[1], mRun, mLimits);
+		_exit(0);
+	}
+
+	close(fds[1]);
+	mPid = pid;
+	mSocket = fds[0];
+	return true;
+}
+
+bool CIsolation_Server::Run(const size_t index, TRun_Record &record, std::string &failure) {
+	int fds[2];
+	if (pipe(fds) != 0) {
+		failure = "cannot create a pipe";
+		return false;
+	}
+
+	bool sent = false;
+	{
+		std::lock_guard<std::mutex> lock{ mLock };
+		sent = (mSocket >= 0) && Send_Request(mSocket, index, fds[1]);
+	}
+	close(fds[1]);	//the server and the child hold their copies
+	if (!sent) {
+		close(fds[0]);
+		failure = "the isolation server is not running";
+		return false;
+	}
+
+	std::string output;
+	const bool timed_out = !Read_Output(fds[0], -1, mLimits.wall_seconds, output);
+	close(fds[0]);
+
+	const TChild_Output child = Parse_Output(output);
+	if (timed_out) {
+		failure = "wall-clock limit exceeded";
+		return false;
+	}
+	if (!child.error.empty()) {
+		failure = child.error;
+		return false;
+	}
+	if (!child.has_status) {
+		failure = "the isolation server has been lost";
+		return false;
+	}
+
+	return Complete_Run(child.status, child.record, record, failure);
+}
+
+void CIsolation_Server::Stop() {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	if (mSocket >= 0) close(mSocket);	//the server leaves once it reads the end of the requests
+	mSocket = -1;
+
+	if (mPid > 0)
+		while ((waitpid(mPid, nullptr, 0) < 0) && (errno == EINTR));
+	mPid = -1;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+struct TRun_Record;
+
+//Limits of a run executed in a child process; 0 means unlimited.
+struct TIsolation_Limits {
+	double cpu_seconds = 0.0;		//RLIMIT_CPU, the child gets SIGXCPU
+	size_t memory_mb = 0;			//RLIMIT_AS, allocations beyond fail, i.e., the solver either fails or crashes
+	double wall_seconds = 3600.0;	//the child is killed, e.g., when it hangs without consuming CPU
+};
+
+//Executes run in a forked child process, which reports the completed record back over a pipe.
+//The child works on a copy of the parent's memory, thus the problem's state and counters of the parent stay untouched.
+//Returns false, if the child has crashed, exceeded a limit or timed out; failure then describes why.
+//Where fork is not available, i.e., on Windows, the run executes in this process.
+bool Run_Isolated(const std::function<void(TRun_Record &record)> &run, TRun_Record &record, const TIsolation_Limits &limits, std::string &failure);
+
+//A worker process, which forks the isolated runs on request. Forking a multi-threaded process copies the locks held by its other threads,
+//e.g., of the allocator, the stdio or a solver library, thus a run forked by a pool thread might deadlock. Hence, the server is started
+//while the process is still single-threaded, i.e., before the pool, and the runs fork from the server's copy of the memory as it was then.
+//A run is therefore requested by its index only; run has to find all that it needs by the index. Where fork is not available, i.e., on Windows,
+//the runs execute in this process.
+class CIsolation_Server {
+protected:
+	std::function<void(const size_t index, TRun_Record &record)> mRun;
+	TIsolation_Limits mLimits;
+	int mPid = -1;
+	int mSocket = -1;	//requests, each carries the run's index and the write end of the pipe for its result
+	std::mutex mLock;
+public:
+	~CIsolation_Server();
+
+	bool Start(const std::function<void(const size_t index, TRun_Record &record)> &run, const TIsolation_Limits &limits);
+	bool Run(const size_t index, TRun_Record &record, std::string &failure);	//thread-safe; the same outcome as Run_Isolated
+	void Stop();
+};
@@ -0,0 +1,212 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "local_cluster.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <map>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <signal.h>
+	#include <unistd.h>
+	#include <sys/wait.h>
+#endif
+
+std::string Substitute_Command(std::string command, const std::string &address, const std::string &library, const size_t worker_index) {
+	auto replace = [&command](const std::string &placeholder, const std::string &value) {
+		for (auto pos = command.find(placeholder); pos != std::string::npos; pos = command.find(placeholder, pos + value.size()))
+			command.replace(pos, placeholder.size(), value);
+	};
+
+	replace("{address}", address);
+	replace("{library}", library);
+	replace("{worker}", std::to_string(worker_index));
+	return command;
+}
+
+CLocal_Cluster::~CLocal_Cluster() {
+	Stop();
+}
+
+bool CLocal_Cluster::Spawn(const std::string &command) {
+#ifdef _WIN32
+	STARTUPINFOA startup_info;
+	PROCESS_INFORMATION process_info;
+	ZeroMemory(&startup_info, sizeof(startup_info));
+	startup_info.cb = sizeof(startup_info);
+
+	std::string command_line = "cmd.exe /c " + command;
+	if (!CreateProcessA(nullptr, command_line.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startup_info, &process_info))
+		return false;
+
+	CloseHandle(process_info.hThread);
+	mProcesses.push_back(process_info.hProcess);
+#else
+	const pid_t pid = fork();
+	if (pid < 0) return false;
+
+	if (pid == 0) {
+		setpgid(0, 0);	//own process group, so that Stop reaches the shell's children too
+		execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+		_exit(127);
+	}
+
+	setpgid(pid, pid);
+	mProcesses.push_back(pid);
+#endif
+
+	return true;
+}
+
+bool CLocal_Cluster::Start(const TCampaign_Options &options, const size_t worker_count) {
+	Stop();
+
+	if (!options.controller_command.empty()) {
+		if (!Spawn(Substitute_Command(options.controller_command, options.distributed_address, options.distributed_library, 0))) return false;
+	}
+
+	if (!options.worker_command.empty()) {
+		for (size_t i = 0; i < worker_count; i++)
+			if (!Spawn(Substitute_Command(options.worker_command, options.distributed_address, options.distributed_library, i))) return false;
+	}
+
+	//there is no readiness protocol with the external processes, give them the configured time to bind and connect
+	if (!mProcesses.empty())
+		std::this_thread::sleep_for(std::chrono::milliseconds(options.cluster_startup_ms));
+
+	return true;
+}
+
+void CLocal_Cluster::Stop() {
+#ifdef _WIN32
+	for (auto process : mProcesses) {
+		TerminateProcess(process, 0);
+		WaitForSingleObject(process, INFINITE);
+		CloseHandle(process);
+	}
+#else
+	for (const auto pid : mProcesses)
+		kill(-pid, SIGTERM);
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	for (const auto pid : mProcesses) {
+		while (waitpid(pid, nullptr, WNOHANG) == 0) {
+			if (std::chrono::steady_clock::now() > deadline) {
+				kill(-pid, SIGKILL);
+				waitpid(pid, nullptr, 0);
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+#endif
+
+	mProcesses.clear();
+}
+
+
+void Sweep_Distributed_Workers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, const TCampaign_Options &options) {
+	TProblem_Info problem_info;
+	problem_info.name = problem->Get_Name();
+	problem_info.ordinal = problem_ordinal_number;
+	problem_info.size = problem->Problem_Size();
+	problem_info.randomized = options.randomize_optimum;
+
+	std::cout << "--=== Distributed worker sweep on " << problem_info.name << " with problem size = " << problem_info.size << "... ===--" << std::endl;
+
+	struct TSweep_Point {
+		size_t workers;
+		double seconds, generations;
+	};
+	std::map<size_t, std::vector<TSweep_Point>> points;	//by the population size, as each has its own baseline
+
+	std::vector<size_t> worker_counts;
+	for (size_t workers = 1; workers < options.distributed_workers; workers *= 2)
+		worker_counts.push_back(workers);
+	worker_counts.push_back(options.distributed_workers);
+
+	for (const size_t workers : worker_counts) {
+		TCampaign_Options sweep_options = options;
+		sweep_options.distributed_workers = workers;	//also a part of the runs' store key, thus each worker count runs on its own
+		sweep_options.solvers = { GUID_To_WString(diagnostic::scgms_distributed_solver::distributed_solver_generic) };
+
+		CLocal_Cluster cluster;
+		if (!cluster.Start(sweep_options, workers)) {
+			std::cout << "Cannot start the local cluster with " << workers << " workers." << std::endl;
+			break;
+		}
+
+		auto results = Run_Solvers(repetitions, problem, problem_info, sweep_options);
+		for (auto &result : results) {
+			if (result.solver_id != diagnostic::scgms_distributed_solver::distributed_solver_generic) continue;
+
+			result.seconds.Calculate_Stats();
+			result.generations.Calculate_Stats();
+			points[result.population_size].push_back({ workers, result.seconds.Get_Stats().med, result.generations.Get_Stats().med });
+		}
+	}
+
+	if (points.empty()) {
+		std::cout << "The distributed solver did not run." << std::endl << std::endl;
+		return;
+	}
+
+	//the overhead is the time above the ideal linear scaling, spread over the generations
+	std::cout << std::endl << "population; workers; median seconds; generations; speedup; efficiency; communication overhead per generation [s]" << std::endl;
+	for (const auto &population : points) {
+		const TSweep_Point &base = population.second.front();	//the fewest workers
+		for (const auto &point : population.second) {
+			const double speedup = base.seconds / point.seconds;
+			const double relative_workers = static_cast<double>(point.workers) / static_cast<double>(base.workers);
+			const double ideal_seconds = base.seconds / relative_workers;
+			const double overhead = point.generations > 0.0 ? (point.seconds - ideal_seconds) / point.generations : std::numeric_limits<double>::quiet_NaN();
+
+			std::cout.precision(3);
+			std::cout << std::scientific;
+			std::cout << population.first << "; " << point.workers << "; " << point.seconds << "; " << point.generations << "; " << speedup << "; " << speedup / relative_workers << "; " << overhead << std::endl;
+		}
+	}
+
+	std::cout << std::endl << "--=== " << problem_info.name << " sweep completed. ===--" << std::endl << std::endl;
+}
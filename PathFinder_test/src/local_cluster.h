@@ -0,0 +1,69 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "solvers.h"
+
+#include <string>
+#include <vector>
+
+//Controller and workers of the distributed solver, spawned as local child processes.
+//The commands are templates, in which {address}, {library} and {worker} (0-based worker index) get substituted.
+//The processes are terminated once the cluster is destroyed.
+class CLocal_Cluster {
+protected:
+#ifdef _WIN32
+	std::vector<void*> mProcesses;	//process handles
+#else
+	std::vector<int> mProcesses;	//pids
+#endif
+
+	bool Spawn(const std::string &command);
+public:
+	~CLocal_Cluster();
+
+	bool Start(const TCampaign_Options &options, const size_t worker_count);
+	void Stop();
+};
+
+std::string Substitute_Command(std::string command, const std::string &address, const std::string &library, const size_t worker_index);
+
+//runs the distributed solver on the same problem with 1, 2, 4, ... options.distributed_workers workers
+//and reports the speedup, parallel efficiency and the communication overhead per generation
+void Sweep_Distributed_Workers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, const TCampaign_Options &options);
@@ -37,8 +37,19 @@
  */
 
 #include "solvers.h"
+#include "result_sink.h"
+#include "result_store.h"
+#include "regression_check.h"
+#include "local_cluster.h"
+#include "simd_kernels.h"
+#include "campaign_spec.h"
+#include "scaling_sweep.h"
+
+#include <scgms/utils/string_utils.h>
 
 #include <iostream>
+#include <thread>
+#include <cstring>
 
 #ifdef WIN32
 	#include <Windows.h>
@@ -51,6 +62,44 @@ int __cdecl main(int argc, char* argv[]) {
 
 	std::cout << "Welcome to the test of the solvers against the Pathfinder." << std::endl << std::endl;
 
+	//the thresholds of the comparison mode may precede or follow it
+	TRegression_Thresholds regression_thresholds;
+	for (size_t i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "-regression_threshold=", 22) == 0)
+			regression_thresholds.relative_change = std::atof(argv[i] + 22);
+		else if (strncmp(argv[i], "-regression_alpha=", 18) == 0)
+			regression_thresholds.alpha = std::atof(argv[i] + 18);
+		else if (strncmp(argv[i], "-regression_effect=", 19) == 0)
+			regression_thresholds.min_effect = std::atof(argv[i] + 19);
+	}
+
+	//the query and compare modes only read already stored results, the verifications do not run any solver
+	for (size_t i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "-compare=", 9) == 0) {
+			const std::string stores = argv[i] + 9;
+			const auto comma = stores.find(',');
+			if (comma == std::string::npos) {
+				std::cout << "The comparison needs two stores: -compare=baseline_store,new_store" << std::endl;
+				return 1;
+			}
+			return Compare_Result_Stores(stores.substr(0, comma), stores.substr(comma + 1), regression_thresholds) == 0 ? 0 : 2;
+		}
+		else if (strncmp(argv[i], "-query=", 7) == 0) {
+			const std::string stores = argv[i] + 7;
+			const auto comma = stores.find(',');
+			Query_Result_Stores(stores.substr(0, comma), comma != std::string::npos ? stores.substr(comma + 1) : std::string{});
+			return 0;
+		}
+		else if (strncmp(argv[i], "-verify_kernels", 15) == 0) {
+			const double max_ulp = argv[i][15] == '=' ? std::atof(argv[i] + 16) : 64.0;
+			return Verify_SIMD_Kernels(max_ulp) == 0 ? 0 : 1;
+		}
+		else if (strncmp(argv[i], "-verify_allocations", 19) == 0) {
+			const size_t size = argv[i][19] == '=' ? std::atoi(argv[i] + 20) : 10;
+			return Verify_Allocation_Free_Objective(size > 0 ? size : 10) == 0 ? 0 : 1;
+		}
+	}
+
 	size_t problem_size = 3;
 	size_t repetitions = 1;
 
@@ -58,38 +107,283 @@ int __cdecl main(int argc, char* argv[]) {
 		problem_size = std::atoi(argv[1]);
 	}
 	else
-		std::cout << "Usage: problem_size [repetitions] [problem_ordinal_number] [-randomize]" << std::endl << std::endl;
+		std::cout << "Usage: problem_size [repetitions] [problem_ordinal_number] [options]" << std::endl
+				  << "   or: -query=store_file[,other_store_file]" << std::endl
+				  << "   or: -compare=baseline_store,new_store [-regression_threshold=0.1] [-regression_alpha=0.05] [-regression_effect=0.33]" << std::endl
+				  << "       exits with 2, if a metric's median regresses by more than the threshold, significantly and with at least the effect size" << std::endl
+				  << "   or: -verify_kernels[=max_ulp]" << std::endl
+				  << "   or: -verify_allocations[=problem_size]" << std::endl
+				  << "   or: -merge=store_file,store_file... [-sink=...]" << std::endl
+				  << "Options:" << std::endl
+				  << "  -campaign=file                   problems, sizes, solvers, population sizes, repetitions and budgets, see campaign_spec.h" << std::endl
+				  << "  -shard=i/N, --shard i/N          runs only the i-th (0..N-1) of N disjoint parts of the campaign" << std::endl
+				  << "  -randomize                       randomizes the optimum in each repetition" << std::endl
+				  << "  -parallel[=workers]              runs the solvers on a work-stealing pool" << std::endl
+				  << "  -sink=anytime|jsonl:file|columnar:directory" << std::endl
+				  << "                                   additional result outputs, may repeat" << std::endl
+				  << "  -store=file                      persists the runs and resumes from them" << std::endl
+				  << "  -build_id=text                   identifies the solver libraries' build for replaying deterministic runs;" << std::endl
+				  << "                                   required to replay them across the campaigns, where the loaded libraries cannot be listed, e.g., on Windows" << std::endl
+				  << "  -budget_seconds=s                stops each run after s seconds of wall-clock time" << std::endl
+				  << "  -budget_evaluations=N            stops each run after N objective calls" << std::endl
+				  << "  -target_epsilon=e                stops each run once fitness <= optimum fitness + e" << std::endl
+				  << "  -adaptive[=width]                repeats each solver only until its ranking is settled, at most repetitions times;" << std::endl
+				  << "                                   width is the 95% confidence interval's half-width relative to the mean, 0.1 by default" << std::endl
+				  << "  -adaptive_min=N                  repetitions before a solver may settle, 5 by default" << std::endl
+				  << "  -adaptive_alpha=a                significance of the test against the leading solver, 0.05 by default" << std::endl
+				  << "  -streaming_stats                 keeps the per-parameter statistics in fixed memory, the quartiles are estimated" << std::endl
+				  << "  -isolate                         runs each solver in a child process, a crash or a hang fails that run only" << std::endl
+				  << "  -isolate_cpu=s                   CPU time limit of an isolated run" << std::endl
+				  << "  -isolate_memory_mb=MB            address space limit of an isolated run" << std::endl
+				  << "  -isolate_timeout=s               wall-clock limit of an isolated run, 3600 by default, 0 - unlimited" << std::endl
+				  << "  -perf_counters                   measures cycles, instructions, cache and branch misses and context switches of each run (Linux)" << std::endl
+				  << "  -memory_profile                  counts the allocations, allocated and peak live bytes and the peak RSS growth of each run (Linux)" << std::endl
+				  << "  -low_noise                       measures the cpu time of each run and flags the runs disturbed by migrations or frequency changes" << std::endl
+				  << "  -pin=cpus                        pins the runs to a core set, e.g., 0-3,6, each parallel worker to one core of it; implies -low_noise" << std::endl
+				  << "  -numa_local                      pinned threads prefer the memory of their node (Linux)" << std::endl
+				  << "  -warm_up=N                       discards N objective calls before each run; implies -low_noise" << std::endl
+				  << "  -cache[=entries]                 memoizes the fitness of the local solvers, 65536 entries by default" << std::endl
+				  << "  -ds_address=address              distributed solver's controller address" << std::endl
+				  << "  -ds_workers=N                    distributed solver's worker count" << std::endl
+				  << "  -ds_controller=command           spawns a local controller; {address}, {library} are substituted" << std::endl
+				  << "  -ds_worker=command               spawns N local workers; {address}, {library}, {worker} are substituted" << std::endl
+				  << "  -ds_startup_ms=ms                time given to the spawned processes to connect" << std::endl
+				  << "  -ds_sweep                        measures the distributed solver with 1, 2, 4, ... N workers" << std::endl
+				  << "  -islands=N                       island count of the Island model solver, the hardware threads by default;" << std::endl
+				  << "                                   the solver runs only when selected, e.g., by the solvers line of a -campaign file" << std::endl
+				  << "  -island_solvers=GUID,...         solvers of the islands, assigned round-robin; the registered ones of a default set by default" << std::endl
+				  << "  -migration_interval=N            generations between the migrations of the islands' bests, 100 by default" << std::endl
+				  << "  -topology=ring|full              migration topology of the islands" << std::endl
+				  << "  -size_sweep[=min:max[:factor]]   runs each problem size of the geometric grid, 2:1024:2 by default, and fits the solvers' scaling exponents" << std::endl
+				  << "  -sweep_budget_seconds=s          stops sweeping a solver once its median run takes, or is predicted to take, more than s seconds" << std::endl
+				  << std::endl;
 
 	if (argc > 2 && isdigit(argv[2][0])) {
 		repetitions = std::atoi(argv[2]);
 	}
 
 
-	bool randomize_optimum = false;
+	TCampaign_Options options;
+	auto sinks = std::make_shared<CComposite_Sink>();
+	sinks->Add(std::make_shared<CCSV_Sink>());
+	options.sink = sinks;
+
+	TCampaign_Spec spec;
+	spec.problem_sizes = { problem_size };
+	spec.repetitions = repetitions;
+	if (argc > 3 && isdigit(argv[3][0])) spec.problems = { argv[3] };
+
+	std::vector<std::string> merged_stores;
+	std::string sweep_sizes;
+
 	for (size_t i = 1; i < argc; i++) {
 
 		if (strcmp(argv[i], "-randomize") == 0) {
 
-			randomize_optimum = true;
+			options.randomize_optimum = true;
 			std::cout << "Will randomize optimum solutions." << std::endl;
-			break;
 		}
+		else if (strncmp(argv[i], "-parallel", 9) == 0) {
+			options.parallel_workers = argv[i][9] == '=' ? std::atoi(argv[i] + 10) : 0;
+			if (options.parallel_workers == 0) options.parallel_workers = std::thread::hardware_concurrency();
+			if (options.parallel_workers == 0) options.parallel_workers = 1;
+			std::cout << "Will run the solvers in parallel with " << options.parallel_workers << " workers." << std::endl;
+		}
+		else if (strncmp(argv[i], "-sink=", 6) == 0) {
+			auto sink = Create_Result_Sink(argv[i] + 6);
+			if (sink) sinks->Add(sink);
+			else std::cout << "Cannot create the result sink " << argv[i] + 6 << ", ignoring it..." << std::endl;
+		}
+		else if (strncmp(argv[i], "-store=", 7) == 0) {
+			options.store = std::make_shared<CResult_Store>(argv[i] + 7);
+			if (options.store->Is_Open()) {
+				sinks->Add(options.store);
+				std::cout << "Will store the results to " << argv[i] + 7 << ", " << options.store->Record_Count() << " runs are already completed." << std::endl;
+			}
+			else {
+				std::cout << "Cannot open the result store " << argv[i] + 7 << ", ignoring it..." << std::endl;
+				options.store.reset();
+			}
+		}
+		else if (strncmp(argv[i], "-budget_seconds=", 16) == 0)
+			options.budget.seconds = std::atof(argv[i] + 16);
+		else if (strncmp(argv[i], "-budget_evaluations=", 20) == 0)
+			options.budget.evaluations = std::strtoull(argv[i] + 20, nullptr, 10);
+		else if (strncmp(argv[i], "-target_epsilon=", 16) == 0)
+			options.budget.target_epsilon = std::atof(argv[i] + 16);
+		else if (strncmp(argv[i], "-adaptive_min=", 14) == 0)
+			options.adaptive.min_repetitions = std::atoi(argv[i] + 14);
+		else if (strncmp(argv[i], "-adaptive_alpha=", 16) == 0)
+			options.adaptive.alpha = std::atof(argv[i] + 16);
+		else if (strncmp(argv[i], "-adaptive", 9) == 0) {
+			options.adaptive.enabled = true;
+			if (argv[i][9] == '=') options.adaptive.relative_ci_width = std::atof(argv[i] + 10);
+		}
+		else if (strcmp(argv[i], "-streaming_stats") == 0)
+			options.streaming_stats = true;
+		else if (strcmp(argv[i], "-isolate") == 0)
+			options.isolated = true;
+		else if (strncmp(argv[i], "-isolate_cpu=", 13) == 0) {
+			options.isolated = true;
+			options.isolation.cpu_seconds = std::atof(argv[i] + 13);
+		}
+		else if (strncmp(argv[i], "-isolate_memory_mb=", 19) == 0) {
+			options.isolated = true;
+			options.isolation.memory_mb = std::strtoull(argv[i] + 19, nullptr, 10);
+		}
+		else if (strncmp(argv[i], "-isolate_timeout=", 17) == 0) {
+			options.isolated = true;
+			options.isolation.wall_seconds = std::atof(argv[i] + 17);
+		}
+		else if (strncmp(argv[i], "-build_id=", 10) == 0)
+			options.build_id = argv[i] + 10;
+		else if (strcmp(argv[i], "-perf_counters") == 0)
+			options.perf_counters = true;
+		else if (strcmp(argv[i], "-memory_profile") == 0)
+			options.memory_profile = true;
+		else if (strcmp(argv[i], "-low_noise") == 0)
+			options.timing.enabled = true;
+		else if (strncmp(argv[i], "-pin=", 5) == 0) {
+			if (!Parse_CPU_Set(argv[i] + 5, options.timing.cpus)) {
+				std::cout << "Invalid cpu set " << argv[i] + 5 << ", expected a list such as 0-3,6." << std::endl;
+				return 1;
+			}
+			options.timing.enabled = true;
+		}
+		else if (strcmp(argv[i], "-numa_local") == 0)
+			options.timing.numa_local = true;
+		else if (strncmp(argv[i], "-warm_up=", 9) == 0) {
+			options.timing.warm_up_evaluations = std::strtoull(argv[i] + 9, nullptr, 10);
+			options.timing.enabled = true;
+		}
+		else if (strncmp(argv[i], "-cache", 6) == 0) {
+			options.fitness_cache_entries = argv[i][6] == '=' ? std::atoi(argv[i] + 7) : 65536;
+			std::cout << "Will cache up to " << options.fitness_cache_entries << " fitness values per run." << std::endl;
+		}
+		else if (strncmp(argv[i], "-ds_address=", 12) == 0)
+			options.distributed_address = argv[i] + 12;
+		else if (strncmp(argv[i], "-ds_workers=", 12) == 0)
+			options.distributed_workers = std::atoi(argv[i] + 12);
+		else if (strncmp(argv[i], "-ds_controller=", 15) == 0)
+			options.controller_command = argv[i] + 15;
+		else if (strncmp(argv[i], "-ds_worker=", 11) == 0)
+			options.worker_command = argv[i] + 11;
+		else if (strncmp(argv[i], "-ds_startup_ms=", 15) == 0)
+			options.cluster_startup_ms = std::atoi(argv[i] + 15);
+		else if (strcmp(argv[i], "-ds_sweep") == 0)
+			options.sweep_distributed_workers = true;
+		else if (strncmp(argv[i], "-islands=", 9) == 0)
+			options.islands.islands = std::atoi(argv[i] + 9);
+		else if (strncmp(argv[i], "-island_solvers=", 16) == 0) {
+			std::string solvers = argv[i] + 16;
+			for (size_t comma = 0; comma != std::string::npos; ) {
+				comma = solvers.find(',');
+				bool ok = false;
+				options.islands.solvers.push_back(WString_To_GUID(Widen_String(solvers.substr(0, comma)), ok));
+				if (!ok) {
+					std::cout << "Invalid solver GUID: " << solvers.substr(0, comma) << std::endl;
+					return 1;
+				}
+				if (comma != std::string::npos) solvers.erase(0, comma + 1);
+			}
+		}
+		else if (strncmp(argv[i], "-migration_interval=", 20) == 0)
+			options.islands.migration_interval = std::atoi(argv[i] + 20);
+		else if (strncmp(argv[i], "-topology=", 10) == 0) {
+			if (!Parse_Migration_Topology(argv[i] + 10, options.islands.topology)) {
+				std::cout << "Unknown migration topology: " << argv[i] + 10 << ", expected ring or full" << std::endl;
+				return 1;
+			}
+		}
+		else if (strncmp(argv[i], "-size_sweep", 11) == 0) {
+			options.sweep_problem_sizes = true;
+			sweep_sizes = argv[i][11] == '=' ? argv[i] + 12 : "2:1024:2";
+		}
+		else if (strncmp(argv[i], "-sweep_budget_seconds=", 22) == 0)
+			options.sweep_budget_seconds = std::atof(argv[i] + 22);
+		else if (strncmp(argv[i], "-campaign=", 10) == 0) {
+			std::string error;
+			if (!Load_Campaign_Spec(argv[i] + 10, spec, options, error)) {
+				std::cout << "Cannot load the campaign: " << error << std::endl;
+				return 1;
+			}
+		}
+		else if ((strncmp(argv[i], "-shard=", 7) == 0) || ((strcmp(argv[i], "--shard") == 0) && (i + 1 < argc))) {
+			const char* shard = argv[i][1] == '-' ? argv[++i] : argv[i] + 7;
+			if (!Parse_Shard(shard, options)) {
+				std::cout << "Invalid shard " << shard << ", expected i/N with i < N." << std::endl;
+				return 1;
+			}
+			std::cout << "Will run the shard " << options.shard_index << " of " << options.shard_count << "." << std::endl;
+		}
+		else if (strncmp(argv[i], "-merge=", 7) == 0) {
+			std::string stores = argv[i] + 7;
+			for (size_t comma = stores.find(','); comma != std::string::npos; comma = stores.find(',')) {
+				merged_stores.push_back(stores.substr(0, comma));
+				stores.erase(0, comma + 1);
+			}
+			merged_stores.push_back(stores);
+		}
+	}
+
+	if (options.distributed_workers == 0) options.distributed_workers = 1;
+	if (options.adaptive.enabled && (options.shard_count > 1)) {
+		std::cout << "The adaptive repetitions need all the cells of a solver, the shard runs the fixed repetitions." << std::endl;
+		options.adaptive.enabled = false;
+	}
+
+	if (!merged_stores.empty()) {
+		Merge_Result_Stores(merged_stores, options);
+		return 0;
 	}
 
-	const auto problems = Create_Problem_Collection(problem_size);
-	size_t low_problem_number = 0;
-	size_t high_problem_number = problems.size()-1;
-	if (argc > 3 && isdigit(argv[3][0])) {
+	//the sweep overrides the sizes of the campaign, regardless of the order of the arguments
+	if (options.sweep_problem_sizes && !Parse_Size_Sweep(sweep_sizes, spec.problem_sizes)) {
+		std::cout << "Invalid problem size sweep " << sweep_sizes << ", expected min:max[:factor] with min <= max and factor > 1." << std::endl;
+		return 1;
+	}
 
-		const size_t user_problem_number = std::atoi(argv[3]);
-		if ((user_problem_number >= low_problem_number) && (user_problem_number <= high_problem_number))
-			low_problem_number = high_problem_number = user_problem_number;
+	//the solvers' threads and the parallel workers inherit the set, a parallel worker then pins itself to a single core of it
+	if (!options.timing.cpus.empty()) {
+		if (Pin_Current_Thread(options.timing.cpus, options.timing.numa_local))
+			std::cout << "Pinned to " << options.timing.cpus.size() << " cpu(s)." << std::endl;
 		else
-			std::cout << "problem_ordinal_number out of bounds, ignoring it..." << std::endl;
+			std::cout << "Cannot pin to the given cpus, the runs are not pinned." << std::endl;
+	}
+
+	auto problem_names_of = [](const auto &problems) {
+		std::vector<std::string> names;
+		for (const auto &problem : problems)
+			names.push_back(problem->Get_Name());
+		return names;
+	};
+
+	//all the problem sizes share the names of the problems
+	if (spec.strict_problems && spec.Selected_Problems(problem_names_of(Create_Problem_Collection(spec.problem_sizes.empty() ? problem_size : spec.problem_sizes.front()))).empty()) {
+		std::cout << "The campaign's problems select no problem of the collection." << std::endl;
+		return 1;
+	}
+
+	CLocal_Cluster cluster;	//no-op unless the controller or worker commands are given
+	if (!options.sweep_distributed_workers && !cluster.Start(options, options.distributed_workers)) {
+		std::cout << "Cannot start the local distributed solver's processes." << std::endl;
+		return 1;
 	}
-	
-	for (size_t problem_number = low_problem_number; problem_number <= high_problem_number; problem_number++) {
-		Evaluate_Solvers(problems[problem_number].get(), repetitions, problem_number, randomize_optimum);
+
+	if (options.sweep_problem_sizes) {
+		Sweep_Problem_Sizes(spec, options);
+		return 0;
+	}
+
+	for (const size_t size : spec.problem_sizes) {
+		const auto problems = Create_Problem_Collection(size);
+
+		for (const size_t problem_number : spec.Selected_Problems(problem_names_of(problems))) {
+			if (options.sweep_distributed_workers)
+				Sweep_Distributed_Workers(problems[problem_number].get(), spec.repetitions, problem_number, options);
+			else
+				Evaluate_Solvers(problems[problem_number].get(), spec.repetitions, problem_number, options);
+		}
 	}
 
 	return 0;
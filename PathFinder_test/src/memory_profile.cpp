@@ -0,0 +1,199 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "memory_profile.h"
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+#ifdef __linux__
+	#include <fstream>
+	#include <string>
+	#include <malloc.h>
+#endif
+
+namespace {
+	struct TAllocation_Counters {
+		std::atomic<uint64_t> allocations{ 0 }, bytes{ 0 };
+		std::atomic<int64_t> live{ 0 }, peak{ 0 };
+
+		void Reset() {
+			allocations = 0;
+			bytes = 0;
+			live = 0;
+			peak = 0;
+		}
+
+		TAllocation_Counts Counts() const {
+			TAllocation_Counts counts;
+			counts.allocations = static_cast<double>(allocations.load());
+			counts.bytes = static_cast<double>(bytes.load());
+			counts.peak_live_bytes = static_cast<double>(peak.load());
+			return counts;
+		}
+	};
+
+	TAllocation_Counters Process_Counters;
+	std::atomic<bool> Process_Tracking{ false };
+	thread_local TAllocation_Counters Thread_Counters;
+	thread_local bool Thread_Tracking = false;
+
+#ifdef __linux__
+	void Track(void* ptr, const bool allocated) {
+		const bool process = Process_Tracking.load(std::memory_order_relaxed);
+		if (!process && !Thread_Tracking) return;
+
+		TAllocation_Counters &counters = process ? Process_Counters : Thread_Counters;
+		const int64_t size = static_cast<int64_t>(malloc_usable_size(ptr));	//also known on delete, unlike the requested size
+		if (allocated) {
+			counters.allocations.fetch_add(1, std::memory_order_relaxed);
+			counters.bytes.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+			const int64_t live = counters.live.fetch_add(size, std::memory_order_relaxed) + size;
+			int64_t peak = counters.peak.load(std::memory_order_relaxed);
+			while ((live > peak) && !counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+		}
+		else
+			counters.live.fetch_sub(size, std::memory_order_relaxed);	//may go below zero for memory allocated before the scope
+	}
+
+	//of /proc/self/status, in bytes
+	double Read_Status_Bytes(const char* key) {
+		std::ifstream status{ "/proc/self/status" };
+		std::string line;
+		const std::string prefix = std::string{ key } + ":";
+		while (std::getline(status, line)) {
+			if (line.compare(0, prefix.size(), prefix) == 0)
+				return std::strtod(line.c_str() + prefix.size(), nullptr) * 1024.0;	//reported in kB
+		}
+
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	//since Linux 4.0, writing 5 resets VmHWM to the current VmRSS
+	bool Reset_Peak_RSS() {
+		std::ofstream clear_refs{ "/proc/self/clear_refs" };
+		clear_refs << "5";
+		clear_refs.flush();
+		return clear_refs.good();
+	}
+#endif
+}
+
+CAllocation_Scope::CAllocation_Scope(const bool process_wide) : mProcess_Wide(process_wide) {
+}
+
+CAllocation_Scope::~CAllocation_Scope() {
+	if (mActive) Stop();
+}
+
+void CAllocation_Scope::Start() {
+#ifdef __linux__
+	if (mProcess_Wide) {
+		if (Reset_Peak_RSS()) mStart_RSS = Read_Status_Bytes("VmRSS");
+		Process_Counters.Reset();
+		Process_Tracking = true;
+	}
+	else {
+		Thread_Counters.Reset();
+		Thread_Tracking = true;
+	}
+
+	mActive = true;
+#endif
+}
+
+TAllocation_Counts CAllocation_Scope::Stop() {
+	TAllocation_Counts counts;
+	if (!mActive) return counts;
+	mActive = false;
+
+#ifdef __linux__
+	if (mProcess_Wide) {
+		Process_Tracking = false;
+		counts = Process_Counters.Counts();
+		counts.peak_rss_delta_bytes = Read_Status_Bytes("VmHWM") - mStart_RSS;	//NaN, if the peak could not be reset
+	}
+	else {
+		Thread_Tracking = false;
+		counts = Thread_Counters.Counts();
+	}
+#endif
+
+	return counts;
+}
+
+
+#ifdef __linux__
+//the replaceable global allocation functions; the array and the remaining nothrow forms forward to these
+void* operator new(std::size_t size) {
+	void* ptr;
+	while ((ptr = std::malloc(size > 0 ? size : 1)) == nullptr) {
+		const std::new_handler handler = std::get_new_handler();
+		if (!handler) throw std::bad_alloc{};
+		handler();
+	}
+
+	Track(ptr, true);
+	return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return ::operator new(size);
+	}
+	catch (...) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* ptr) noexcept {
+	if (!ptr) return;
+	Track(ptr, false);
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	::operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+	::operator delete(ptr);
+}
+#endif
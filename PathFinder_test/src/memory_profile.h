@@ -0,0 +1,65 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <limits>
+
+struct TAllocation_Counts {
+	double allocations = std::numeric_limits<double>::quiet_NaN();
+	double bytes = std::numeric_limits<double>::quiet_NaN();	//allocated, i.e., the sum of the usable sizes
+	double peak_live_bytes = std::numeric_limits<double>::quiet_NaN();	//above the live bytes at the start of the scope
+	double peak_rss_delta_bytes = std::numeric_limits<double>::quiet_NaN();	//VmHWM above VmRSS at the start, process-wide scopes only
+};
+
+//Counts the allocations made through the global operator new, which this executable replaces on Linux.
+//A process-wide scope counts the allocations of all threads, e.g., of the solver's own threads, thus only one may be active at a time;
+//a thread scope counts the calling thread's allocations only, so that concurrent runs do not mix.
+//Elsewhere, the counts stay NaN.
+class CAllocation_Scope {
+protected:
+	const bool mProcess_Wide;
+	bool mActive = false;
+	double mStart_RSS = std::numeric_limits<double>::quiet_NaN();
+public:
+	CAllocation_Scope(const bool process_wide);
+	~CAllocation_Scope();
+
+	void Start();
+	TAllocation_Counts Stop();
+};
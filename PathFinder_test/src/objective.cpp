@@ -0,0 +1,287 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "objective.h"
+#include "scratch_arena.h"
+#include "memory_profile.h"
+#include "run_budget.h"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <iostream>
+
+CLatency_Histogram::CLatency_Histogram() {
+	for (auto &bucket : mBuckets)
+		bucket.store(0, std::memory_order_relaxed);
+}
+
+size_t CLatency_Histogram::Bucket_Index(const uint64_t value) {
+	if (value < Linear_Limit) return static_cast<size_t>(value);
+
+	size_t exponent = 0;	//floor(log2(value)), at least 4 here
+	for (uint64_t tmp = value; tmp > 1; tmp >>= 1) exponent++;
+
+	const size_t sub_bucket = static_cast<size_t>(value >> (exponent - Sub_Buckets_Log2)) & ((1 << Sub_Buckets_Log2) - 1);
+	return Linear_Limit + (exponent - 4) * (1 << Sub_Buckets_Log2) + sub_bucket;
+}
+
+double CLatency_Histogram::Bucket_Middle(const size_t index) {
+	if (index < Linear_Limit) return static_cast<double>(index);
+
+	const size_t exponent = (index - Linear_Limit) / (1 << Sub_Buckets_Log2) + 4;
+	const size_t sub_bucket = (index - Linear_Limit) % (1 << Sub_Buckets_Log2);
+	const double width = std::ldexp(1.0, static_cast<int>(exponent - Sub_Buckets_Log2));
+	return std::ldexp(1.0, static_cast<int>(exponent)) + (static_cast<double>(sub_bucket) + 0.5) * width;
+}
+
+void CLatency_Histogram::Record(const uint64_t nanoseconds, const uint64_t count) {
+	mBuckets[Bucket_Index(nanoseconds)].fetch_add(count, std::memory_order_relaxed);
+}
+
+uint64_t CLatency_Histogram::Count() const {
+	uint64_t count = 0;
+	for (const auto &bucket : mBuckets)
+		count += bucket.load(std::memory_order_relaxed);
+	return count;
+}
+
+double CLatency_Histogram::Quantile(const double q) const {
+	const uint64_t count = Count();
+	if (count == 0) return std::numeric_limits<double>::quiet_NaN();
+
+	const uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count)));
+	uint64_t so_far = 0;
+	for (size_t i = 0; i < Bucket_Count; i++) {
+		so_far += mBuckets[i].load(std::memory_order_relaxed);
+		if ((so_far >= rank) && (so_far > 0)) return Bucket_Middle(i);
+	}
+
+	return Bucket_Middle(Bucket_Count - 1);
+}
+
+
+void CConvergence_Trace::Record(const double fitness) {
+	const uint64_t call = mCalls.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	double best = mBest.load(std::memory_order_relaxed);
+	while ((fitness < best) && !mBest.compare_exchange_weak(best, fitness, std::memory_order_relaxed));	//NaN never compares less
+
+	if (call >= mNext_Checkpoint.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> lock{ mLock };
+
+		uint64_t next = mNext_Checkpoint.load(std::memory_order_relaxed);
+		if (call < next) return;	//another thread has just recorded this checkpoint
+
+		if (mCount < Capacity - 1) mPoints[mCount++] = { call, mBest.load(std::memory_order_relaxed) };
+
+		while (next <= call) {
+			mCheckpoint_Exponent++;
+			next = static_cast<uint64_t>(std::ceil(std::pow(10.0, static_cast<double>(mCheckpoint_Exponent) / static_cast<double>(Checkpoints_Per_Decade))));
+		}
+		mNext_Checkpoint.store(next, std::memory_order_relaxed);
+	}
+}
+
+double CConvergence_Trace::Best() const {
+	return mBest.load(std::memory_order_relaxed);
+}
+
+void CConvergence_Trace::Get_Points(std::vector<TConvergence_Point> &points) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	const uint64_t calls = mCalls.load();
+	if ((calls > 0) && ((mCount == 0) || (mPoints[mCount - 1].call != calls)))
+		mPoints[mCount++] = { calls, mBest.load() };
+
+	points.assign(mPoints.begin(), mPoints.begin() + mCount);
+}
+
+namespace {
+	TObjective_Context& Objective_Context(const void* data) {
+		//the solver sees the context as const data only, the counters are ours
+		return *const_cast<TObjective_Context*>(static_cast<const TObjective_Context*>(data));
+	}
+
+	uint64_t Elapsed_Nanoseconds(const std::chrono::steady_clock::time_point &start, const std::chrono::steady_clock::time_point &stop) {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+	}
+
+	//true for a real call of the problem, false for a cache hit
+	bool Evaluate_Candidate(TObjective_Context &context, const double *candidate, double &fitness) {
+		if (!context.cache) {
+			fitness = context.problem->Calculate_Fitness(candidate);
+			return true;
+		}
+
+		const uint64_t hash = context.cache->Hash(candidate);
+		if (context.cache->Lookup(candidate, hash, fitness)) return false;
+
+		fitness = context.problem->Calculate_Fitness(candidate);
+		context.cache->Insert(candidate, hash, fitness);
+		return true;
+	}
+
+	//Candidate(i) returns a pointer to the i-th candidate's contiguous parameters
+	template <typename TCandidate>
+	void Evaluate_Batch(TObjective_Context &context, const size_t count, double* const fitness, TCandidate &&Candidate) {
+		uint64_t batch_nanoseconds = 0;
+		uint64_t real_calls = 0;
+
+		uint8_t *is_real = Thread_Scratch<uint8_t>(NScratch_Buffer::Real_Calls, count);
+
+		//one clock read per candidate, as the consecutive reads delimit the calls, so that each call has its own latency sample
+		auto previous = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; i++) {
+			is_real[i] = Evaluate_Candidate(context, Candidate(i), fitness[i]);
+			const auto now = std::chrono::steady_clock::now();
+			const uint64_t nanoseconds = Elapsed_Nanoseconds(previous, now);
+			previous = now;
+
+			batch_nanoseconds += nanoseconds;
+			if (is_real[i]) {
+				context.latency.Record(nanoseconds);
+				real_calls++;
+			}
+		}
+
+		for (size_t i = 0; i < count; i++)
+			if (is_real[i]) context.trace.Record(fitness[i]);
+
+		const uint64_t calls = context.calls.fetch_add(real_calls, std::memory_order_relaxed) + real_calls;
+		context.objective_nanoseconds.fetch_add(batch_nanoseconds, std::memory_order_relaxed);
+
+		if ((context.evaluation_budget > 0) && (calls >= context.evaluation_budget) && context.watchdog)
+			context.watchdog->Request_Cancel();
+	}
+}
+
+BOOL IfaceCalling Instrumented_Objective(const void* data, const size_t count, const double* solution, double* const fitness) {
+	TObjective_Context &context = Objective_Context(data);
+	const size_t problem_size = context.problem_size;
+
+	Evaluate_Batch(context, count, fitness, [solution, problem_size](const size_t i) { return solution + i * problem_size; });
+
+	return TRUE;
+}
+
+size_t Verify_Allocation_Free_Objective(const size_t problem_size) {
+	const size_t batch_size = 16;
+	const size_t warm_up_rounds = 4;
+	const size_t measured_rounds = 256;
+	const size_t rounds = warm_up_rounds + measured_rounds;
+
+	{
+		CAllocation_Scope probe{ false };
+		probe.Start();
+		if (std::isnan(probe.Stop().allocations)) {
+			std::cout << "The allocations cannot be counted on this platform, nothing verified." << std::endl;
+			return 0;
+		}
+	}
+
+	struct TObjective_Path {
+		const char* name;
+		size_t count;
+		bool cached;
+	};
+	const TObjective_Path paths[] = {
+		{ "single", 1, false },
+		{ "batch", batch_size, false },
+		{ "cached batch", batch_size, true },
+	};
+
+	std::cout << "problem; objective path; allocations per candidate; of them in Calculate_Fitness" << std::endl;
+
+	size_t failed = 0;
+	std::mt19937_64 random_generator{ 20181 };
+	std::vector<double> candidates, fitness(batch_size);
+	const auto problems = Create_Problem_Collection(problem_size);
+	for (const auto &problem : problems) {
+		if (!problem->Can_Be_Solved()) continue;
+
+		//generated before counting
+		CSolution lower_bound, upper_bound;
+		problem->get_bounds(lower_bound, upper_bound);
+		candidates.resize(rounds * batch_size * problem_size);
+		for (size_t r = 0; r < rounds; r++)
+			for (size_t i = 0; i < batch_size; i++)
+				for (size_t d = 0; d < problem_size; d++)
+					candidates[(r * batch_size + i) * problem_size + d] = std::uniform_real_distribution<double>{ lower_bound[d], upper_bound[d] }(random_generator);
+
+		for (const auto &path : paths) {
+			TObjective_Context context{ problem.get() };
+			if (path.cached)
+				context.cache = std::make_unique<CFitness_Cache>(problem_size, 1024);	//fewer entries than the candidates, i.e., evicts too
+
+			auto evaluate = [&](const size_t round) {
+				Instrumented_Objective(&context, path.count, candidates.data() + round * batch_size * problem_size, fitness.data());
+			};
+
+			for (size_t r = 0; r < warm_up_rounds; r++)
+				evaluate(r);
+
+			CAllocation_Scope scope{ false };
+			scope.Start();
+			for (size_t r = warm_up_rounds; r < rounds; r++)
+				evaluate(r);
+			const double allocations = scope.Stop().allocations;
+
+			//the problem's own share, with the very same candidates
+			scope.Start();
+			for (size_t r = warm_up_rounds; r < rounds; r++)
+				for (size_t i = 0; i < path.count; i++)
+					fitness[i] = problem->Calculate_Fitness(candidates.data() + (r * batch_size + i) * problem_size);
+			const double problem_allocations = scope.Stop().allocations;
+
+			const double candidates = static_cast<double>(measured_rounds * path.count);
+			const bool ok = allocations == 0.0;
+			if (!ok) failed++;
+
+			std::cout << problem->Get_Name() << "; " << path.name << "; " << allocations / candidates << "; " << problem_allocations / candidates << (ok ? "" : "; allocates") << std::endl;
+		}
+	}
+
+	if (failed == 0)
+		std::cout << "No objective path allocates in the steady state." << std::endl;
+	else
+		std::cout << failed << " objective path(s) allocate in the steady state!" << std::endl;
+
+	return failed;
+}
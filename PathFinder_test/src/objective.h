@@ -0,0 +1,128 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "TProblemData.h"
+#include "fitness_cache.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class CRun_Watchdog;
+
+//Lock-free histogram of durations in nanoseconds.
+//Values below 16 have exact buckets, larger ones are split to 4 sub-buckets per power of two, i.e., ~12% resolution.
+class CLatency_Histogram {
+public:
+	static constexpr size_t Sub_Buckets_Log2 = 2;
+	static constexpr size_t Linear_Limit = 16;
+	static constexpr size_t Bucket_Count = Linear_Limit + (64 - 4) * (1 << Sub_Buckets_Log2);
+protected:
+	std::array<std::atomic<uint64_t>, Bucket_Count> mBuckets;
+
+	static size_t Bucket_Index(const uint64_t value);
+	static double Bucket_Middle(const size_t index);
+public:
+	CLatency_Histogram();
+
+	void Record(const uint64_t nanoseconds, const uint64_t count = 1);
+	uint64_t Count() const;
+	double Quantile(const double q) const;	//NaN if empty
+};
+
+struct TConvergence_Point {
+	uint64_t call;	//1-based index of the objective call
+	double fitness;	//best-so-far fitness after that call
+};
+
+//Best-so-far fitness sampled at log-spaced objective calls (1, 2, 3, 4, 6, ..., 10, 13, 16, 20, 26, ...), 10 per decade.
+//The buffer is preallocated, recording does not allocate.
+class CConvergence_Trace {
+public:
+	static constexpr size_t Checkpoints_Per_Decade = 10;
+	static constexpr size_t Capacity = 16 * Checkpoints_Per_Decade + 1;	//up to 1e16 calls plus the final point
+protected:
+	std::array<TConvergence_Point, Capacity> mPoints;
+	size_t mCount = 0;
+	size_t mCheckpoint_Exponent = 0;
+	std::mutex mLock;	//taken when crossing a checkpoint only
+
+	std::atomic<uint64_t> mCalls{ 0 };
+	std::atomic<uint64_t> mNext_Checkpoint{ 1 };
+	std::atomic<double> mBest{ std::numeric_limits<double>::infinity() };
+public:
+	void Record(const double fitness);
+	double Best() const;	//best-so-far fitness, infinity before the first call
+	void Get_Points(std::vector<TConvergence_Point> &points);	//appends the final point, if it is not a checkpoint
+};
+
+//The objective handed to the solvers through TSolver_Setup::data.
+//Calls CCommon_Problem::Calculate_Fitness, i.e., the problem's call counters stay exact, and measures each call.
+//With a cache, the hits do not reach the problem, thus they are not counted as calls nor recorded in the latency and the trace.
+struct TObjective_Context {
+	CCommon_Problem *problem = nullptr;
+	size_t problem_size = 0;
+	std::unique_ptr<CFitness_Cache> cache;	//optional
+
+	CLatency_Histogram latency;	//of the single calls
+	std::atomic<uint64_t> calls{ 0 };	//real calls of the problem
+	std::atomic<uint64_t> objective_nanoseconds{ 0 };	//summed over all the solver's threads
+
+	CConvergence_Trace trace;
+
+	//the evaluation budget is checked on each call, so that a fast objective does not overshoot it by the watchdog's poll period
+	uint64_t evaluation_budget = 0;	//0 - unlimited
+	CRun_Watchdog *watchdog = nullptr;	//cancels the solver, once the budget is exhausted
+
+	TObjective_Context(CCommon_Problem *working_problem) : problem(working_problem), problem_size(working_problem->Problem_Size()) {};
+};
+
+//Evaluates count candidates at once, e.g., a whole generation, i.e., solution[i*problem_size + d] as TObjective_Function does, and writes count fitness values.
+//Each candidate is timed on its own, a batch reads the clock once per candidate.
+BOOL IfaceCalling Instrumented_Objective(const void* data, const size_t count, const double* solution, double* const fitness);
+
+//Evaluates random candidates of each problem of the collection through the objective's paths, i.e., a single candidate,
+//a batch and a cached batch, and counts their allocations once warmed up, see CAllocation_Scope.
+//Returns the number of paths, which allocate in the steady state.
+size_t Verify_Allocation_Free_Objective(const size_t problem_size);
@@ -0,0 +1,148 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "perf_counters.h"
+
+#ifdef __linux__
+	#include <cstring>
+	#include <cstdint>
+	#include <unistd.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <linux/perf_event.h>
+#endif
+
+namespace {
+	constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+#ifdef __linux__
+	struct TCounter_Event {
+		uint32_t type;
+		uint64_t config;
+	};
+
+	constexpr uint64_t Cache_Event(const uint64_t cache, const uint64_t op, const uint64_t result) {
+		return cache | (op << 8) | (result << 16);
+	}
+
+	//in the order of NPerf_Counter
+	const std::array<TCounter_Event, static_cast<size_t>(NPerf_Counter::count)> Counter_Events = { {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, Cache_Event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },	//last level cache
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+	} };
+
+	int Open_Counter(const TCounter_Event &event) {
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = event.type;
+		attr.config = event.config;
+		attr.disabled = 1;
+		attr.inherit = 1;	//the solver's threads started while counting
+		attr.exclude_kernel = 1;	//allowed with perf_event_paranoid <= 2
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));	//this thread, any cpu, no group
+	}
+#endif
+}
+
+CPerf_Counters::CPerf_Counters() {
+	mDescriptors.fill(-1);
+}
+
+CPerf_Counters::~CPerf_Counters() {
+#ifdef __linux__
+	for (const int descriptor : mDescriptors)
+		if (descriptor >= 0) close(descriptor);
+#endif
+}
+
+bool CPerf_Counters::Start() {
+#ifdef __linux__
+	bool any = false;
+	for (size_t i = 0; i < mDescriptors.size(); i++) {
+		if (mDescriptors[i] < 0) mDescriptors[i] = Open_Counter(Counter_Events[i]);
+		if (mDescriptors[i] >= 0) {
+			ioctl(mDescriptors[i], PERF_EVENT_IOC_RESET, 0);
+			any = true;
+		}
+	}
+
+	//enabled as late as possible, so that the opening does not count
+	for (const int descriptor : mDescriptors)
+		if (descriptor >= 0) ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+
+	mCounting = any;
+#endif
+
+	return mCounting;
+}
+
+TPerf_Counts CPerf_Counters::Stop() {
+	TPerf_Counts counts;
+	counts.fill(NaN);
+	if (!mCounting) return counts;
+	mCounting = false;
+
+#ifdef __linux__
+	for (const int descriptor : mDescriptors)
+		if (descriptor >= 0) ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+	for (size_t i = 0; i < mDescriptors.size(); i++) {
+		if (mDescriptors[i] < 0) continue;
+
+		uint64_t values[3];	//value, time enabled, time running
+		if (read(mDescriptors[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) continue;
+
+		if (values[2] > 0)
+			counts[i] = static_cast<double>(values[0]) * (static_cast<double>(values[1]) / static_cast<double>(values[2]));
+		else if (values[1] == 0)
+			counts[i] = 0.0;	//nothing has run, e.g., an instant run
+		//else the counter has never been scheduled, i.e., it stays NaN
+	}
+#endif
+
+	return counts;
+}
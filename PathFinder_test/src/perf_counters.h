@@ -0,0 +1,71 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <cstddef>
+
+enum class NPerf_Counter : size_t {
+	Cycles = 0,
+	Instructions,
+	L1D_Read_Misses,
+	LLC_Misses,
+	Branch_Misses,
+	Context_Switches,
+	CPU_Migrations,
+	count
+};
+
+using TPerf_Counts = std::array<double, static_cast<size_t>(NPerf_Counter::count)>;
+
+//Performance counters of the calling thread and of the threads it starts while counting, read via perf_event_open.
+//Each counter is opened on its own, so that the kernel can multiplex them; the counts are then scaled by the time enabled/running.
+//Degrades to a no-op, i.e., NaN counts, when a counter is not available, e.g., on paranoid kernels, in containers or on other platforms than Linux.
+class CPerf_Counters {
+protected:
+	std::array<int, static_cast<size_t>(NPerf_Counter::count)> mDescriptors;
+	bool mCounting = false;
+public:
+	CPerf_Counters();
+	~CPerf_Counters();
+
+	bool Start();	//false, if none of the counters is available
+	TPerf_Counts Stop();	//NaN for the unavailable counters, or when not started
+};
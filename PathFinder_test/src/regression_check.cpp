@@ -0,0 +1,171 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "regression_check.h"
+#include "result_store.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	using TCell_Key = std::tuple<size_t, size_t, GUID, size_t>;	//problem ordinal, problem size, solver, population size
+
+	constexpr size_t metric_count = 4;
+	const char* metric_names[metric_count] = { "seconds", "total_objective_calls", "least_objective_call_001", "fitness_error" };
+
+	struct TCell {
+		std::string problem;
+		std::wstring solver;
+		std::vector<double> samples[2][metric_count];	//baseline, new
+		size_t fails[2] = { 0, 0 };
+	};
+
+	struct TChange {
+		const TCell* cell;
+		TCell_Key key;
+		size_t metric;
+		double baseline_median, new_median, relative_change, effect, p_value;
+		bool regression, exceeds;
+	};
+
+	double Median(const std::vector<double> &values) {
+		CStats stats;
+		for (const double value : values)
+			if (!std::isnan(value)) stats.push_back(value);
+		stats.Calculate_Stats();
+		return stats.Get_Stats().med;
+	}
+
+	double Relative_Change(const double baseline, const double current) {
+		if (baseline != 0.0) return (current - baseline) / std::fabs(baseline);
+		if (current == baseline) return 0.0;
+		return current > baseline ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+	}
+}
+
+size_t Compare_Result_Stores(const std::string &baseline_store_file, const std::string &new_store_file, const TRegression_Thresholds &thresholds) {
+	std::map<TCell_Key, TCell> cells;
+
+	auto load = [&cells](const std::string &file_name, const size_t index) {
+		CResult_Store store{ file_name, false };
+		std::cout << "Store " << file_name << ": " << store.Record_Count() << " runs, " << store.Corrupted_Line_Count() << " corrupted lines" << std::endl;
+
+		for (const auto &record : store.Records()) {
+			auto &cell = cells[TCell_Key{ record.problem_ordinal, record.problem_size, record.solver_id, record.population_size }];
+			cell.problem = record.problem_name;
+			cell.solver = record.solver_name;
+			if (record.failed) {
+				cell.fails[index]++;
+				continue;
+			}
+
+			const double values[metric_count] = { record.seconds, record.total_objective_calls, record.least_objective_call_001, record.fitness_error };
+			for (size_t m = 0; m < metric_count; m++)
+				cell.samples[index][m].push_back(values[m]);
+		}
+	};
+
+	load(baseline_store_file, 0);
+	load(new_store_file, 1);
+	std::cout << std::endl;
+
+	std::vector<TChange> changes;
+	size_t matched = 0, unmatched = 0;
+	for (const auto &iter : cells) {
+		const TCell &cell = iter.second;
+		const bool in_baseline = !cell.samples[0][0].empty() || (cell.fails[0] > 0);
+		const bool in_new = !cell.samples[1][0].empty() || (cell.fails[1] > 0);
+		if (!in_baseline || !in_new) {
+			unmatched++;
+			continue;
+		}
+		matched++;
+
+		for (size_t m = 0; m < metric_count; m++) {
+			const auto &baseline = cell.samples[0][m], &current = cell.samples[1][m];
+
+			TChange change{ &cell, iter.first, m };
+			change.p_value = Mann_Whitney_P_Value(current, baseline);
+			change.effect = Cliffs_Delta(current, baseline);	//positive, if the new values tend to be greater, i.e., worse
+			if (std::isnan(change.effect) || (change.p_value >= thresholds.alpha) || (std::fabs(change.effect) < thresholds.min_effect)) continue;
+
+			change.baseline_median = Median(baseline);
+			change.new_median = Median(current);
+			change.relative_change = Relative_Change(change.baseline_median, change.new_median);
+			change.regression = change.effect > 0.0;
+			change.exceeds = change.regression && (change.relative_change > thresholds.relative_change);
+			changes.push_back(change);
+		}
+
+		if (cell.fails[1] > cell.fails[0])
+			std::wcout << L"More failures: " << cell.solver << L" on " << Widen_String(cell.problem) << L" of size " << std::get<1>(iter.first)
+					   << L", " << cell.fails[0] << L" -> " << cell.fails[1] << std::endl;
+	}
+
+	//the worst regressions first, then the best improvements
+	std::sort(changes.begin(), changes.end(), [](const TChange &a, const TChange &b) {
+		if (a.regression != b.regression) return a.regression;
+		return std::fabs(a.relative_change) > std::fabs(b.relative_change);
+	});
+
+	std::cout << "Matched cells: " << matched << ", unmatched cells: " << unmatched << ", significant changes: " << changes.size() << std::endl;
+	std::cout << "alpha: " << thresholds.alpha << ", relative change threshold: " << thresholds.relative_change << ", minimal |Cliff's delta|: " << thresholds.min_effect << std::endl << std::endl;
+
+	std::cout << "verdict; problem; ordinal; size; solver; population; metric; baseline median; new median; relative change; cliff's delta; p-value; baseline runs; new runs" << std::endl;
+	size_t regressions = 0;
+	const auto old_precision = std::cout.precision(3);
+	std::cout << std::scientific;
+	for (const auto &change : changes) {
+		if (change.exceeds) regressions++;
+
+		std::cout << (change.exceeds ? "REGRESSION" : change.regression ? "regression within threshold" : "improvement") << "; "
+				  << change.cell->problem << "; " << std::get<0>(change.key) << "; " << std::get<1>(change.key) << "; ";
+		std::wcout << change.cell->solver;
+		std::cout << "; " << std::get<3>(change.key) << "; " << metric_names[change.metric] << "; "
+				  << change.baseline_median << "; " << change.new_median << "; " << change.relative_change << "; " << change.effect << "; " << change.p_value << "; "
+				  << change.cell->samples[0][change.metric].size() << "; " << change.cell->samples[1][change.metric].size() << std::endl;
+	}
+	std::cout << std::defaultfloat;
+	std::cout.precision(old_precision);
+
+	std::cout << std::endl << "Regressions exceeding the threshold: " << regressions << std::endl;
+	return regressions;
+}
@@ -0,0 +1,53 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <string>
+
+//when a cell's metric counts as a regression, the metrics are all the lower the better
+struct TRegression_Thresholds {
+	double alpha = 0.05;	//of the two-sided Mann-Whitney test of each metric in each cell
+	double relative_change = 0.1;	//of the median, which must be exceeded, e.g., 0.1 for 10% slower
+	double min_effect = 0.33;	//|Cliff's delta|, i.e., at least a medium effect
+};
+
+//Compares the runs of a new store to a baseline store, cell by cell, i.e., by the problem, its size, the solver and its population size,
+//in seconds, total objective calls, least objective call to 0.01 and fitness error. Prints the significant changes, the worst regressions first.
+//Returns the number of the regressions, which exceed the thresholds.
+size_t Compare_Result_Stores(const std::string &baseline_store_file, const std::string &new_store_file, const TRegression_Thresholds &thresholds);
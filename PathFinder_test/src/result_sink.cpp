@@ -0,0 +1,509 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "result_sink.h"
+#include "anytime_report.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+
+void CComposite_Sink::Add(std::shared_ptr<IResult_Sink> sink) {
+	mSinks.push_back(sink);
+}
+
+void CComposite_Sink::Begin_Problem(const TProblem_Info &problem) {
+	for (auto &sink : mSinks)
+		sink->Begin_Problem(problem);
+}
+
+void CComposite_Sink::Append_Run(const TRun_Record &record) {
+	for (auto &sink : mSinks)
+		sink->Append_Run(record);
+}
+
+void CComposite_Sink::End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) {
+	for (auto &sink : mSinks)
+		sink->End_Problem(problem, results);
+}
+
+
+namespace {
+	//the columns between param_err and total calls of each statistic's block of the csv report
+	struct TCSV_Column {
+		const char* header;
+		CStats TSolver_Result::* stats;
+		const char* feature;	//nullptr - always printed, otherwise only if a result of the feature has a value
+	};
+
+	const std::vector<TCSV_Column> CSV_Columns = {
+		{ "time", &TSolver_Result::seconds, nullptr },
+		{ "evals/s", &TSolver_Result::evaluations_per_second, nullptr },
+		{ "objective time", &TSolver_Result::objective_seconds, nullptr },
+		{ "overhead time", &TSolver_Result::overhead_seconds, nullptr },
+		{ "p50 call ns", &TSolver_Result::call_latency_p50, nullptr },
+		{ "p99 call ns", &TSolver_Result::call_latency_p99, nullptr },
+		{ "cache hits", &TSolver_Result::cache_hits, "cache" },
+		{ "cache misses", &TSolver_Result::cache_misses, "cache" },
+		{ "time budget", &TSolver_Result::time_budget_used, "budget" },
+		{ "evals budget", &TSolver_Result::evaluation_budget_used, "budget" },
+		{ "cycles/eval", &TSolver_Result::cycles_per_evaluation, "perf" },
+		{ "instr/eval", &TSolver_Result::instructions_per_evaluation, "perf" },
+		{ "ipc", &TSolver_Result::instructions_per_cycle, "perf" },
+		{ "L1d miss/eval", &TSolver_Result::l1d_misses_per_evaluation, "perf" },
+		{ "LLC miss/eval", &TSolver_Result::llc_misses_per_evaluation, "perf" },
+		{ "branch miss/eval", &TSolver_Result::branch_misses_per_evaluation, "perf" },
+		{ "ctx switches", &TSolver_Result::context_switches, "perf" },
+		{ "allocs", &TSolver_Result::allocations, "memory" },
+		{ "alloc bytes", &TSolver_Result::allocated_bytes, "memory" },
+		{ "peak live bytes", &TSolver_Result::peak_live_bytes, "memory" },
+		{ "allocs/eval", &TSolver_Result::allocations_per_evaluation, "memory" },
+		{ "peak rss delta", &TSolver_Result::peak_rss_delta_bytes, "memory" },
+		{ "cpu time", &TSolver_Result::cpu_seconds, "timing" },
+		{ "migrations", &TSolver_Result::cpu_migrations, "timing" },
+		{ "disturbed", &TSolver_Result::disturbed, "timing" },
+	};
+
+	//the columns of the features, which have given a value to some of the results, i.e., which were enabled
+	std::vector<const TCSV_Column*> Enabled_CSV_Columns(const std::vector<TSolver_Result> &results) {
+		std::set<std::string> features;
+		for (const auto &column : CSV_Columns) {
+			if (!column.feature) continue;
+			for (const auto &result : results) {
+				const CStats &stats = result.*column.stats;
+				if (std::any_of(stats.begin(), stats.end(), [](const double value) { return !std::isnan(value); })) features.insert(column.feature);
+			}
+		}
+
+		std::vector<const TCSV_Column*> columns;
+		for (const auto &column : CSV_Columns)
+			if (!column.feature || (features.find(column.feature) != features.end())) columns.push_back(&column);
+		return columns;
+	}
+}
+
+void CCSV_Sink::End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) {
+	if (results.empty()) return;
+
+	const size_t problem_size = problem.size;
+	const auto columns = Enabled_CSV_Columns(results);
+
+	std::cout << std::endl;
+	std::string title_line = "general;;;;;;;;;;";
+	std::string header_line = "solver; reps; fails; stops; param_err; fitness_err; least_calls; lc_001; param_err001; ";
+
+	auto add_params = [&title_line, &header_line, &columns, problem_size](const char* title) {
+		title_line += title;
+		title_line += std::string(columns.size() + 8, ';');
+		header_line += "; fitness; fitness_err; param_err; ";
+		for (const auto *column : columns) {
+			header_line += column->header;
+			header_line += "; ";
+		}
+		header_line += "total calls; least calls; lc_001; pe_001; ";
+		for (size_t i = 0; i < problem_size; i++) {
+			title_line += "; ";
+			header_line += std::to_string(i);
+			header_line += "; ";
+		}
+	};
+
+	add_params("Average");
+	add_params("Standard Deviation");
+	add_params("Minimum");
+	add_params("Q25");
+	add_params("Median");
+	add_params("Q75");
+	add_params("Maximum");
+
+	std::cout << title_line << std::endl;
+	std::cout << header_line << std::endl;
+
+
+	auto write_marker = [problem_size, &columns](auto getter, const TSolver_Result &result) {
+		std::cout.precision(std::numeric_limits< double >::max_digits10);
+		std::cout << std::scientific;
+		std::cout << getter(result.fitness) << "; ";
+		std::cout << getter(result.fitness_error) << "; ";
+		std::cout << getter(result.abs_parameter_error) << "; ";
+
+		std::cout.precision(3);
+		for (const auto *column : columns)
+			std::cout << getter(result.*column->stats) << "; ";
+
+		std::cout.precision(std::numeric_limits< double >::max_digits10);
+		std::cout << std::scientific;
+		std::cout << getter(result.total_objective_calls) << "; ";
+		std::cout << getter(result.least_objective_call) << "; ";
+		std::cout << getter(result.least_objective_call_001) << "; ";
+		std::cout << getter(result.abs_parameter_error_001);
+
+
+		for (size_t i = 0; i < problem_size; i++)
+			std::cout << "; " << getter(result.parameters[i]);
+
+		std::cout << ";;";
+	};
+
+	auto write_avg_stddev = [](auto getter) {
+		const auto &stats = getter().Get_Stats();
+		std::cout << stats.avg << " � " << stats.stddev << "; ";
+	};
+
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const auto &result = results[i];
+		std::wcout << result.name << "; " << result.repetitions << "; " << result.fail_count << "; ";
+		for (size_t reason = 0; reason < result.stop_reasons.size(); reason++)
+			if (result.stop_reasons[reason] > 0) std::cout << Stop_Reason_Name(static_cast<NStop_Reason>(reason)) << ":" << result.stop_reasons[reason] << " ";
+		std::cout << "; ";
+		std::cout.precision(3);
+		std::cout << std::scientific;
+
+		write_avg_stddev([&result]() {return result.abs_parameter_error; });
+		write_avg_stddev([&result]() {return result.fitness_error; });
+		write_avg_stddev([&result]() {return result.least_objective_call; });
+		write_avg_stddev([&result]() {return result.least_objective_call_001; });
+		write_avg_stddev([&result]() {return result.abs_parameter_error_001; });
+
+		std::cout << ";";
+		write_marker([](const auto &stats) {return stats.Get_Stats().avg; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().stddev; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().min; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().q25; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().med; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().q75; }, result);
+		write_marker([](const auto &stats) {return stats.Get_Stats().max; }, result);
+		std::cout << std::endl;
+	}
+}
+
+
+namespace {
+	std::string Escape_JSON(const std::string &str) {
+		std::string result;
+		for (const char c : str) {
+			switch (c) {
+				case '"': result += "\\\""; break;
+				case '\\': result += "\\\\"; break;
+				case '\n': result += "\\n"; break;
+				case '\t': result += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						char buf[8];
+						snprintf(buf, sizeof(buf), "\\u%04x", c);
+						result += buf;
+					} else
+						result += c;
+			}
+		}
+
+		return result;
+	}
+
+	void Write_JSON_Number(std::ostream &stream, const double value) {
+		if (std::isfinite(value)) stream << value;
+		else stream << "null";	//JSON has no NaN or infinity
+	}
+}
+
+CJSONL_Sink::CJSONL_Sink(const std::string &file_name) : mFile(file_name, std::ios::out | std::ios::app) {
+	mFile.precision(std::numeric_limits<double>::max_digits10);
+}
+
+bool CJSONL_Sink::Is_Open() const {
+	return mFile.is_open();
+}
+
+void CJSONL_Sink::Append_Run(const TRun_Record &record) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	mFile << "{\"problem\":\"" << Escape_JSON(record.problem_name) << "\"";
+	mFile << ",\"problem_ordinal\":" << record.problem_ordinal;
+	mFile << ",\"problem_size\":" << record.problem_size;
+	mFile << ",\"solver_id\":\"" << Narrow_WString(GUID_To_WString(record.solver_id)) << "\"";
+	mFile << ",\"solver\":\"" << Escape_JSON(Narrow_WString(record.solver_name)) << "\"";
+	mFile << ",\"population_size\":" << record.population_size;
+	mFile << ",\"repetition\":" << record.repetition;
+	mFile << ",\"failed\":" << (record.failed ? "true" : "false");
+	mFile << ",\"stop_reason\":\"" << Stop_Reason_Name(record.stop_reason) << "\"";
+
+	for (const auto &metric : Run_Metrics) {
+		mFile << ",\"" << metric.name << "\":";
+		Write_JSON_Number(mFile, record.*metric.value);
+	}
+
+	auto write_vector = [this](const char* name, const std::vector<double> &values) {
+		mFile << ",\"" << name << "\":[";
+		for (size_t i = 0; i < values.size(); i++) {
+			if (i > 0) mFile << ',';
+			Write_JSON_Number(mFile, values[i]);
+		}
+		mFile << ']';
+	};
+
+	write_vector("optimum", record.optimum);
+	write_vector("parameters", record.parameters);
+	write_vector("parameters_001", record.parameters_001);
+
+	mFile << ",\"convergence\":[";
+	for (size_t i = 0; i < record.convergence.size(); i++) {
+		if (i > 0) mFile << ',';
+		mFile << '[' << record.convergence[i].call << ',';
+		Write_JSON_Number(mFile, record.convergence[i].fitness);
+		mFile << ']';
+	}
+	mFile << ']';
+
+	mFile << "}" << std::endl;	//flush, so that a partial campaign can be analyzed
+}
+
+
+namespace {
+	std::string Columnar_Schema() {
+		std::ostringstream schema;
+		schema << "problem u32 string_id" << std::endl;
+		schema << "solver u32 string_id" << std::endl;
+		schema << "solver_id u32 string_id" << std::endl;
+		schema << "problem_ordinal f64" << std::endl;
+		schema << "problem_size f64" << std::endl;
+		schema << "population_size f64" << std::endl;
+		schema << "repetition f64" << std::endl;
+		schema << "failed f64" << std::endl;
+		schema << "stop_reason u32 string_id" << std::endl;
+		for (const auto &metric : Run_Metrics)
+			schema << metric.name << " f64" << std::endl;
+		schema << "optimum f64 vector" << std::endl;
+		schema << "parameters f64 vector" << std::endl;
+		schema << "parameters_001 f64 vector" << std::endl;
+		schema << "convergence_calls f64 vector" << std::endl;
+		schema << "convergence_fitness_error f64 vector" << std::endl;
+		return schema.str();
+	}
+}
+
+CColumnar_Sink::CColumnar_Sink(const std::string &directory) : mDirectory(directory) {
+	const std::filesystem::path path{ mDirectory };
+	std::error_code ec;
+	std::filesystem::create_directories(path, ec);
+
+	//the rows of a previous, possibly interrupted, campaign
+	std::map<std::string, uint64_t> committed_sizes;
+	{
+		std::ifstream committed{ path / "committed.txt" };
+		std::string name;
+		uint64_t size;
+		while (committed >> name >> size) {
+			if (name == "rows") mRows = size;
+			else committed_sizes[name] = size;
+		}
+	}
+
+	const std::string schema = Columnar_Schema();
+	std::string existing_schema;
+	{
+		std::ifstream existing{ path / "schema.txt" };
+		std::ostringstream content;
+		content << existing.rdbuf();
+		existing_schema = content.str();
+	}
+
+	if (existing_schema != schema) {
+		if (mRows > 0) {
+			std::cout << "The columns of " << mDirectory << " differ from the current ones, cannot append to it." << std::endl;
+			return;
+		}
+
+		std::ofstream schema_file{ path / "schema.txt", std::ios::out | std::ios::trunc };
+		schema_file << schema;
+		if (!schema_file.good()) return;
+	}
+
+	//a crash may have left a partial row in some of the files => cut all of them back to the committed rows
+	const bool has_commit = std::filesystem::exists(path / "committed.txt");
+	for (const auto &entry : std::filesystem::directory_iterator{ path, ec }) {
+		const std::string name = entry.path().filename().string();
+		if ((name == "schema.txt") || (name.compare(0, 9, "committed") == 0) || !entry.is_regular_file()) continue;
+		if (!has_commit && (entry.file_size() > 0)) {
+			std::cout << mDirectory << " has rows of unknown completeness, cannot append to it." << std::endl;
+			return;
+		}
+
+		const auto committed = committed_sizes.find(name);
+		std::filesystem::resize_file(entry.path(), committed != committed_sizes.end() ? committed->second : 0, ec);
+	}
+
+	//continue the string dictionary
+	const auto strings_path = path / "strings.txt";
+	{
+		std::ifstream existing{ strings_path };
+		std::string line;
+		while (std::getline(existing, line))
+			mString_Ids.emplace(line, static_cast<uint32_t>(mString_Ids.size()));
+	}
+	mStrings.open(strings_path, std::ios::out | std::ios::app);
+	mOpened = mStrings.is_open();
+}
+
+void CColumnar_Sink::Commit_Row() {
+	mRows++;
+
+	mStrings.flush();
+	for (auto &column : mColumns)
+		column.second.flush();
+
+	//the sizes of the complete rows, replaced at once by the rename
+	const std::filesystem::path path{ mDirectory };
+	{
+		std::ofstream committed{ path / "committed.tmp", std::ios::out | std::ios::trunc };
+		committed << "rows " << mRows << std::endl;
+		committed << "strings.txt " << static_cast<uint64_t>(mStrings.tellp()) << std::endl;
+		for (auto &column : mColumns)
+			committed << column.first << ' ' << static_cast<uint64_t>(column.second.tellp()) << std::endl;
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(path / "committed.tmp", path / "committed.txt", ec);
+}
+
+bool CColumnar_Sink::Is_Open() const {
+	return mOpened;
+}
+
+std::ofstream& CColumnar_Sink::Column(const std::string &name, const char* extension) {
+	const std::string file_name = name + extension;
+	auto iter = mColumns.find(file_name);
+	if (iter == mColumns.end())
+		iter = mColumns.emplace(file_name, std::ofstream{ std::filesystem::path{ mDirectory } / file_name, std::ios::out | std::ios::app | std::ios::binary }).first;
+
+	return iter->second;
+}
+
+uint32_t CColumnar_Sink::String_Id(const std::string &str) {
+	const auto iter = mString_Ids.find(str);
+	if (iter != mString_Ids.end()) return iter->second;
+
+	const uint32_t id = static_cast<uint32_t>(mString_Ids.size());
+	mString_Ids[str] = id;
+	mStrings << str << std::endl;
+	return id;
+}
+
+void CColumnar_Sink::Write_Vector(const std::string &name, const std::vector<double> &values) {
+	auto &offsets = Column(name, ".offsets.u64");
+	auto offset = mVector_Offsets.find(name);
+	if (offset == mVector_Offsets.end()) {	//resume after the values written previously
+		std::error_code ec;
+		const auto existing_size = std::filesystem::file_size(std::filesystem::path{ mDirectory } / (name + ".f64"), ec);
+		offset = mVector_Offsets.emplace(name, ec ? 0 : static_cast<uint64_t>(existing_size / sizeof(double))).first;
+	}
+
+	offsets.write(reinterpret_cast<const char*>(&offset->second), sizeof(offset->second));
+	Column(name, ".f64").write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+	offset->second += values.size();
+}
+
+void CColumnar_Sink::Append_Run(const TRun_Record &record) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	auto write_id = [this](const char* name, const std::string &str) {
+		const uint32_t id = String_Id(str);
+		Column(name, ".u32").write(reinterpret_cast<const char*>(&id), sizeof(id));
+	};
+	auto write_scalar = [this](const char* name, const double value) {
+		Column(name, ".f64").write(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+
+	write_id("problem", record.problem_name);
+	write_id("solver", Narrow_WString(record.solver_name));
+	write_id("solver_id", Narrow_WString(GUID_To_WString(record.solver_id)));
+	write_scalar("problem_ordinal", static_cast<double>(record.problem_ordinal));
+	write_scalar("problem_size", static_cast<double>(record.problem_size));
+	write_scalar("population_size", static_cast<double>(record.population_size));
+	write_scalar("repetition", static_cast<double>(record.repetition));
+	write_scalar("failed", record.failed ? 1.0 : 0.0);
+	write_id("stop_reason", Stop_Reason_Name(record.stop_reason));
+
+	for (const auto &metric : Run_Metrics)
+		write_scalar(metric.name, record.*metric.value);
+
+	Write_Vector("optimum", record.optimum);
+	Write_Vector("parameters", record.parameters);
+	Write_Vector("parameters_001", record.parameters_001);
+
+	std::vector<double> convergence_calls, convergence_errors;
+	for (const auto &point : record.convergence) {
+		convergence_calls.push_back(static_cast<double>(point.call));
+		convergence_errors.push_back(point.fitness);
+	}
+	Write_Vector("convergence_calls", convergence_calls);
+	Write_Vector("convergence_fitness_error", convergence_errors);
+
+	//complete rows only, so that a partial campaign can be mapped
+	Commit_Row();
+}
+
+
+std::shared_ptr<IResult_Sink> Create_Result_Sink(const std::string &specification) {
+	const auto separator = specification.find(':');
+	const std::string format = specification.substr(0, separator);
+	const std::string target = separator != std::string::npos ? specification.substr(separator + 1) : std::string{};
+
+	if (format == "csv") return std::make_shared<CCSV_Sink>();
+	if (format == "anytime") return std::make_shared<CAnytime_Report_Sink>();
+
+	if (target.empty()) return nullptr;
+
+	if (format == "jsonl") {
+		auto sink = std::make_shared<CJSONL_Sink>(target);
+		if (sink->Is_Open()) return sink;
+	}
+	else if (format == "columnar") {
+		auto sink = std::make_shared<CColumnar_Sink>(target);
+		if (sink->Is_Open()) return sink;
+	}
+
+	return nullptr;
+}
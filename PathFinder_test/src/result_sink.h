@@ -0,0 +1,119 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "solvers.h"
+
+#include <fstream>
+#include <map>
+
+//Receives the results of an evaluation as they are produced.
+//Append_Run may be called concurrently by the parallel workers, hence the implementations lock themselves.
+class IResult_Sink {
+public:
+	virtual ~IResult_Sink() = default;
+
+	virtual void Begin_Problem(const TProblem_Info &problem) {};
+	virtual void Append_Run(const TRun_Record &record) {};	//called as soon as each Run_Solver finishes
+	virtual void End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) {};	//results are already sorted and their stats calculated
+};
+
+//distributes the results to several sinks
+class CComposite_Sink : public IResult_Sink {
+protected:
+	std::vector<std::shared_ptr<IResult_Sink>> mSinks;
+public:
+	void Add(std::shared_ptr<IResult_Sink> sink);
+
+	virtual void Begin_Problem(const TProblem_Info &problem) override;
+	virtual void Append_Run(const TRun_Record &record) override;
+	virtual void End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) override;
+};
+
+//the original semicolon-separated report printed to the console once a problem is evaluated;
+//the columns of an optional feature, e.g., the performance counters, are printed only if some run of the problem has measured them
+class CCSV_Sink : public IResult_Sink {
+public:
+	virtual void End_Problem(const TProblem_Info &problem, const std::vector<TSolver_Result> &results) override;
+};
+
+//one JSON object per run, appended and flushed as each run finishes
+class CJSONL_Sink : public IResult_Sink {
+protected:
+	std::mutex mLock;
+	std::ofstream mFile;
+public:
+	CJSONL_Sink(const std::string &file_name);
+	bool Is_Open() const;
+
+	virtual void Append_Run(const TRun_Record &record) override;
+};
+
+//Directory of memory-mappable columns, one row per run.
+//Each scalar column is a raw array of little-endian doubles in <column>.f64; strings are stored
+//as uint32 indices to strings.txt (one string per line); per-parameter vectors are flattened
+//to <column>.f64 with the uint64 row start offsets in <column>.offsets.u64. The layout is described in schema.txt.
+//committed.txt holds the row count and the byte size of each file after the last complete row; the files may be longer
+//after a crash, thus the readers map the committed sizes only, and a resumed sink cuts the files back to them.
+//A directory with rows of other columns, e.g., of a build with other Run_Metrics, is refused.
+class CColumnar_Sink : public IResult_Sink {
+protected:
+	std::mutex mLock;
+	std::string mDirectory;
+	bool mOpened = false;
+
+	std::map<std::string, std::ofstream> mColumns;
+	std::ofstream mStrings;
+	std::map<std::string, uint32_t> mString_Ids;
+	std::map<std::string, uint64_t> mVector_Offsets;
+	uint64_t mRows = 0;
+
+	std::ofstream& Column(const std::string &name, const char* extension);
+	uint32_t String_Id(const std::string &str);
+	void Write_Vector(const std::string &name, const std::vector<double> &values);
+	void Commit_Row();
+public:
+	CColumnar_Sink(const std::string &directory);
+	bool Is_Open() const;
+
+	virtual void Append_Run(const TRun_Record &record) override;
+};
+
+//creates a sink from the command-line specification "csv", "anytime", "jsonl:file_name" or "columnar:directory"
+std::shared_ptr<IResult_Sink> Create_Result_Sink(const std::string &specification);
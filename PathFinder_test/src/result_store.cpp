@@ -0,0 +1,470 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "result_store.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <set>
+
+namespace {
+	constexpr uint64_t FNV_Offset = 14695981039346656037ULL;
+	constexpr uint64_t FNV_Prime = 1099511628211ULL;
+
+	uint64_t FNV1a(const void* data, const size_t size, uint64_t hash = FNV_Offset) {
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= FNV_Prime;
+		}
+		return hash;
+	}
+
+	std::string Format_Double(const double value) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.17g", value);	//round-trips exactly
+		return buf;
+	}
+
+	std::string Format_Vector(const std::vector<double> &values) {
+		std::string result;
+		for (size_t i = 0; i < values.size(); i++) {
+			if (i > 0) result += ',';
+			result += Format_Double(values[i]);
+		}
+		return result;
+	}
+
+	std::vector<double> Parse_Vector(const std::string &str) {
+		std::vector<double> result;
+		const char* pos = str.c_str();
+		while (*pos) {
+			char* end = nullptr;
+			result.push_back(strtod(pos, &end));
+			if (end == pos) break;
+			pos = *end == ',' ? end + 1 : end;
+		}
+		return result;
+	}
+
+	const char* Fail_Marker_Name(const NFail_Marker marker) {
+		switch (marker) {
+			case NFail_Marker::Crashed: return "crashed";
+			case NFail_Marker::Faulty: return "faulty";
+			default: return "none";
+		}
+	}
+
+	NFail_Marker Fail_Marker_From_Name(const std::string &name) {
+		if (name == "crashed") return NFail_Marker::Crashed;
+		if (name == "faulty") return NFail_Marker::Faulty;
+		return NFail_Marker::None;
+	}
+
+	std::string Sanitize(std::string str) {	//the separators must not appear inside the values
+		for (auto &c : str)
+			if ((c == '\t') || (c == '\n') || (c == '\r')) c = ' ';
+		return str;
+	}
+}
+
+TRun_Key Run_Key(const TRun_Record &record) {
+	return TRun_Key{ record.problem_ordinal, record.problem_size, record.solver_id, record.population_size, record.repetition, record.shift_fingerprint, Limits_Fingerprint(record) };
+}
+
+TDeterministic_Key Deterministic_Key(const TRun_Record &record) {
+	return TDeterministic_Key{ record.solver_id, record.problem_name, record.problem_size, record.population_size, record.shift_fingerprint, record.build_hash, Limits_Fingerprint(record) };
+}
+
+uint64_t Cell_Hash(const TRun_Record &record, const bool whole_instance) {
+	const uint64_t fields[] = { record.problem_ordinal, record.problem_size, record.population_size, whole_instance ? 0 : record.repetition };
+	const uint64_t hash = FNV1a(fields, sizeof(fields));
+	return FNV1a(&record.solver_id, sizeof(record.solver_id), hash);
+}
+
+uint64_t Limits_Fingerprint(const TRun_Record &record) {
+	//NaN has many bit patterns, no target is hashed as the same one
+	const double target_epsilon = std::isnan(record.budget.target_epsilon) ? std::numeric_limits<double>::quiet_NaN() : record.budget.target_epsilon;
+	const uint64_t generations = record.max_generations, evaluations = record.budget.evaluations;
+
+	uint64_t hash = FNV1a(&generations, sizeof(generations));
+	hash = FNV1a(&record.budget.seconds, sizeof(record.budget.seconds), hash);
+	hash = FNV1a(&evaluations, sizeof(evaluations), hash);
+	hash = FNV1a(&target_epsilon, sizeof(target_epsilon), hash);
+	if (record.distributed_workers == 0) return hash;	//the same keys as the stores written before
+
+	const uint64_t workers = record.distributed_workers;
+	return FNV1a(&workers, sizeof(workers), hash);
+}
+
+uint64_t Build_Hash(const std::string &build_description) {
+	const uint64_t hash = FNV1a(build_description.data(), build_description.size());
+	return hash != 0 ? hash : 1;
+}
+
+void Replay_Run_Record(const TRun_Record &source, TRun_Record &record) {
+	TRun_Record replayed = source;
+	replayed.solver_id = record.solver_id;
+	replayed.solver_name = record.solver_name;
+	replayed.problem_name = record.problem_name;
+	replayed.problem_ordinal = record.problem_ordinal;
+	replayed.problem_size = record.problem_size;
+	replayed.population_size = record.population_size;
+	replayed.repetition = record.repetition;
+	replayed.shift_fingerprint = record.shift_fingerprint;
+	replayed.build_hash = record.build_hash;
+	replayed.max_generations = record.max_generations;
+	replayed.budget = record.budget;
+	replayed.distributed_workers = record.distributed_workers;
+
+	record = std::move(replayed);
+}
+
+uint64_t Shift_Fingerprint(const CSolution &optimum, const double optimum_fitness) {
+	uint64_t hash = FNV1a(optimum.data(), static_cast<size_t>(optimum.size()) * sizeof(double));
+	return FNV1a(&optimum_fitness, sizeof(optimum_fitness), hash);
+}
+
+std::string Serialize_Run_Record(const TRun_Record &record) {
+	std::string line = "run";
+	auto add = [&line](const char* name, const std::string &value) {
+		line += '\t';
+		line += name;
+		line += '=';
+		line += value;
+	};
+
+	add("problem_ordinal", std::to_string(record.problem_ordinal));
+	add("problem_size", std::to_string(record.problem_size));
+	add("solver_id", Narrow_WString(GUID_To_WString(record.solver_id)));
+	add("population_size", std::to_string(record.population_size));
+	add("repetition", std::to_string(record.repetition));
+	add("shift", std::to_string(record.shift_fingerprint));
+	add("build", std::to_string(record.build_hash));
+	add("max_generations", std::to_string(record.max_generations));
+	add("budget_seconds", Format_Double(record.budget.seconds));
+	add("budget_evaluations", std::to_string(record.budget.evaluations));
+	add("target_epsilon", Format_Double(record.budget.target_epsilon));
+	add("distributed_workers", std::to_string(record.distributed_workers));
+	add("stop", Stop_Reason_Name(record.stop_reason));
+	add("problem", Sanitize(record.problem_name));
+	add("solver", Sanitize(Narrow_WString(record.solver_name)));
+	add("failed", record.failed ? "1" : "0");
+	add("fail_marker", Fail_Marker_Name(record.fail_marker));
+	add("randomized", record.randomized ? "1" : "0");
+
+	for (const auto &metric : Run_Metrics)
+		add(metric.name, Format_Double(record.*metric.value));
+
+	add("optimum", Format_Vector(record.optimum));
+	add("parameters", Format_Vector(record.parameters));
+	add("parameters_001", Format_Vector(record.parameters_001));
+
+	std::string convergence;
+	for (const auto &point : record.convergence) {
+		if (!convergence.empty()) convergence += ',';
+		convergence += std::to_string(point.call) + ':' + Format_Double(point.fitness);
+	}
+	add("convergence", convergence);
+
+	char checksum[24];
+	snprintf(checksum, sizeof(checksum), "%016llx", static_cast<unsigned long long>(FNV1a(line.data(), line.size())));
+	add("checksum", checksum);
+
+	return line;
+}
+
+bool Deserialize_Run_Record(const std::string &line, TRun_Record &record) {
+	const auto checksum_pos = line.rfind("\tchecksum=");
+	if ((line.compare(0, 3, "run") != 0) || (checksum_pos == std::string::npos)) return false;
+
+	char checksum[24];
+	snprintf(checksum, sizeof(checksum), "%016llx", static_cast<unsigned long long>(FNV1a(line.data(), checksum_pos)));
+	if (line.compare(checksum_pos + 10, std::string::npos, checksum) != 0) return false;
+
+	std::map<std::string, std::string> fields;
+	std::istringstream stream{ line.substr(0, checksum_pos) };
+	std::string field;
+	while (std::getline(stream, field, '\t')) {
+		const auto eq = field.find('=');
+		if (eq != std::string::npos) fields[field.substr(0, eq)] = field.substr(eq + 1);
+	}
+
+	auto to_size = [&fields](const char* name) { return static_cast<size_t>(std::strtoull(fields[name].c_str(), nullptr, 10)); };
+
+	record = TRun_Record{};
+	record.problem_ordinal = to_size("problem_ordinal");
+	record.problem_size = to_size("problem_size");
+	bool ok = false;
+	record.solver_id = WString_To_GUID(Widen_String(fields["solver_id"]), ok);
+	if (!ok) return false;
+	record.population_size = to_size("population_size");
+	record.repetition = to_size("repetition");
+	record.shift_fingerprint = std::strtoull(fields["shift"].c_str(), nullptr, 10);
+	record.build_hash = std::strtoull(fields["build"].c_str(), nullptr, 10);	//0, i.e., unknown, in the stores written before
+	record.max_generations = to_size("max_generations");	//0 and no budget, i.e., the runs are not reused by a campaign, in the stores written before
+	record.budget.seconds = strtod(fields["budget_seconds"].c_str(), nullptr);
+	record.budget.evaluations = std::strtoull(fields["budget_evaluations"].c_str(), nullptr, 10);
+	if (fields.find("target_epsilon") != fields.end()) record.budget.target_epsilon = strtod(fields["target_epsilon"].c_str(), nullptr);
+	record.distributed_workers = to_size("distributed_workers");
+	record.problem_name = fields["problem"];
+	record.solver_name = Widen_String(fields["solver"]);
+	record.failed = fields["failed"] == "1";
+	record.fail_marker = Fail_Marker_From_Name(fields["fail_marker"]);
+	record.randomized = fields["randomized"] == "1";	//the stores written before only tell by more than one shift fingerprint
+	record.stop_reason = Stop_Reason_From_Name(fields["stop"]);
+
+	for (const auto &metric : Run_Metrics) {
+		const auto iter = fields.find(metric.name);	//metrics added later than the store was written stay NaN
+		if (iter != fields.end()) record.*metric.value = strtod(iter->second.c_str(), nullptr);
+	}
+
+	record.optimum = Parse_Vector(fields["optimum"]);
+	record.parameters = Parse_Vector(fields["parameters"]);
+	record.parameters_001 = Parse_Vector(fields["parameters_001"]);
+	if ((record.fail_marker == NFail_Marker::None) && ((record.optimum.size() != record.problem_size) || (record.parameters.size() != record.problem_size))) return false;
+
+	std::istringstream convergence{ fields["convergence"] };
+	std::string point;
+	while (std::getline(convergence, point, ',')) {
+		const auto colon = point.find(':');
+		if (colon == std::string::npos) return false;
+		record.convergence.push_back({ std::strtoull(point.c_str(), nullptr, 10), strtod(point.c_str() + colon + 1, nullptr) });
+	}
+
+	return true;
+}
+
+
+CResult_Store::CResult_Store(const std::string &file_name, const bool writable) : mFile_Name(file_name) {
+	{
+		std::ifstream existing{ file_name };
+		std::string line;
+		while (std::getline(existing, line)) {
+			if (line.empty()) continue;
+
+			TRun_Record record;
+			if (Deserialize_Run_Record(line, record)) Insert(record);
+			else mCorrupted_Lines++;
+		}
+	}
+
+	if (writable) mFile.open(file_name, std::ios::out | std::ios::app);
+}
+
+void CResult_Store::Insert(const TRun_Record &record) {
+	mRecords[Run_Key(record)] = record;
+	if (!record.failed && (record.build_hash != 0) && (record.stop_reason == NStop_Reason::Completed)) mDeterministic_Records[Deterministic_Key(record)] = record;
+}
+
+bool CResult_Store::Is_Open() const {
+	return mFile.is_open();
+}
+
+size_t CResult_Store::Record_Count() const {
+	return mRecords.size();
+}
+
+size_t CResult_Store::Corrupted_Line_Count() const {
+	return mCorrupted_Lines;
+}
+
+bool CResult_Store::Find(TRun_Record &record) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	const auto iter = mRecords.find(Run_Key(record));
+	if (iter == mRecords.end()) return false;
+
+	record = iter->second;
+	return true;
+}
+
+bool CResult_Store::Find_Deterministic(TRun_Record &record) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	if (record.build_hash == 0) return false;
+	const auto iter = mDeterministic_Records.find(Deterministic_Key(record));
+	if (iter == mDeterministic_Records.end()) return false;
+
+	Replay_Run_Record(iter->second, record);
+	return true;
+}
+
+std::vector<TRun_Record> CResult_Store::Records() const {
+	std::vector<TRun_Record> records;
+	for (const auto &record : mRecords)
+		records.push_back(record.second);
+	return records;
+}
+
+void CResult_Store::Append_Run(const TRun_Record &record) {
+	std::lock_guard<std::mutex> lock{ mLock };
+
+	//a torn line of a previous crash would corrupt this record too => start it on a fresh line
+	mFile << std::endl << Serialize_Run_Record(record) << std::endl;
+	Insert(record);
+}
+
+
+void Query_Result_Stores(const std::string &store_file, const std::string &other_store_file) {
+	using TGroup_Key = std::tuple<size_t, size_t, std::wstring>;	//problem ordinal, problem size, solver name with the population size
+
+	struct TGroup {
+		std::string problem;
+		TSolver_Result result[2];
+	};
+
+	std::map<TGroup_Key, TGroup> groups;
+
+	auto load = [&groups](const std::string &file_name, const size_t index) {
+		CResult_Store store{ file_name, false };
+		std::cout << "Store " << file_name << ": " << store.Record_Count() << " runs, " << store.Corrupted_Line_Count() << " corrupted lines" << std::endl;
+
+		for (const auto &record : store.Records()) {
+			auto &group = groups[TGroup_Key{ record.problem_ordinal, record.problem_size, record.solver_name }];
+			group.problem = record.problem_name;
+			auto &result = group.result[index];
+			result.name = record.solver_name;
+			Prepare_Solver_Result(result, record.problem_size, false);
+			Append_Run_Record(result, record);
+		}
+	};
+
+	const bool compare = !other_store_file.empty();
+	load(store_file, 0);
+	if (compare) load(other_store_file, 1);
+	std::cout << std::endl;
+
+	std::cout << "problem; ordinal; size; solver; runs; fails; avg fitness_err; avg seconds; avg lc_001";
+	if (compare) std::cout << "; other runs; other fails; other avg fitness_err; other avg seconds; other avg lc_001; seconds ratio";
+	std::cout << std::endl;
+
+	std::cout.precision(3);
+	std::cout << std::scientific;
+	for (auto &group : groups) {
+		std::cout << group.second.problem << "; " << std::get<0>(group.first) << "; " << std::get<1>(group.first) << "; ";
+		std::wcout << std::get<2>(group.first);
+
+		for (size_t i = 0; i < (compare ? 2 : 1); i++) {
+			auto &result = group.second.result[i];
+			result.fitness_error.Calculate_Stats();
+			result.seconds.Calculate_Stats();
+			result.least_objective_call_001.Calculate_Stats();
+
+			std::cout << "; " << result.seconds.size() << "; " << result.fail_count;
+			std::cout << "; " << result.fitness_error.Get_Stats().avg << "; " << result.seconds.Get_Stats().avg << "; " << result.least_objective_call_001.Get_Stats().avg;
+		}
+
+		if (compare) std::cout << "; " << group.second.result[1].seconds.Get_Stats().avg / group.second.result[0].seconds.Get_Stats().avg;
+		std::cout << std::endl;
+	}
+}
+
+void Merge_Result_Stores(const std::vector<std::string> &store_files, const TCampaign_Options &options) {
+	//the shards are disjoint, yet a cell may have been run by more than one of them, e.g., after a restart with another sharding
+	std::map<TRun_Key, TRun_Record> records;
+	for (const auto &file_name : store_files) {
+		CResult_Store store{ file_name, false };
+		std::cout << "Store " << file_name << ": " << store.Record_Count() << " runs, " << store.Corrupted_Line_Count() << " corrupted lines" << std::endl;
+
+		for (auto &record : store.Records()) {
+			auto &merged = records[Run_Key(record)];
+			if ((merged.solver_id == Invalid_GUID) || ((merged.fail_marker != NFail_Marker::None) && (record.fail_marker == NFail_Marker::None)))
+				merged = std::move(record);	//a run of another shard supersedes a failure marker
+		}
+	}
+	std::cout << std::endl;
+
+	using TProblem_Key = std::tuple<size_t, size_t>;	//problem size, problem ordinal
+	using TResult_Key = std::tuple<GUID, size_t>;		//solver, population size
+
+	struct TProblem_Group {
+		TProblem_Info info;
+		std::set<uint64_t> shifts;
+		std::vector<const TRun_Record*> runs;
+		std::map<TResult_Key, TSolver_Result> results;
+	};
+
+	std::map<TProblem_Key, TProblem_Group> problems;
+	for (const auto &iter : records) {
+		const TRun_Record &record = iter.second;
+		auto &group = problems[TProblem_Key{ record.problem_size, record.problem_ordinal }];
+		group.info.name = record.problem_name;
+		group.info.ordinal = record.problem_ordinal;
+		group.info.size = record.problem_size;
+		group.shifts.insert(record.shift_fingerprint);
+		group.info.randomized = group.info.randomized || record.randomized;
+		if (record.fail_marker == NFail_Marker::None) group.runs.push_back(&record);
+
+		auto &result = group.results[TResult_Key{ record.solver_id, record.population_size }];
+		if (result.name.empty()) {
+			result.name = record.solver_name;
+			result.solver_id = record.solver_id;
+			result.population_size = record.population_size;
+			Prepare_Solver_Result(result, record.problem_size, options.streaming_stats);
+		}
+		Append_Run_Record(result, record);
+	}
+
+	CCSV_Sink default_sink;
+	IResult_Sink &sink = options.sink ? *options.sink : default_sink;
+
+	for (auto &iter : problems) {
+		auto &group = iter.second;
+		group.info.randomized = group.info.randomized || (group.shifts.size() > 1);	//the stores written before do not persist the flag
+
+		std::cout << "--=== Merged results of " << group.info.name << " with problem size = " << group.info.size << "... ===--" << std::endl;
+		std::cout << "Problem ordinal number: " << group.info.ordinal << std::endl;
+
+		sink.Begin_Problem(group.info);
+		for (const auto *record : group.runs)
+			sink.Append_Run(*record);
+
+		std::vector<TSolver_Result> results;
+		for (auto &result : group.results)
+			results.push_back(std::move(result.second));
+		Report_Results(group.info, results, sink);
+
+		std::cout << std::endl << "--=== " << group.info.name << " merge completed. ===--" << std::endl << std::endl;
+	}
+}
@@ -0,0 +1,95 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "result_sink.h"
+
+#include <tuple>
+
+//identifies a single cell of a campaign; the shift fingerprint distinguishes the (possibly randomized) problem instances
+//and the limits fingerprint the run's max_generations, budget and distributed worker count, so that a campaign with other limits does not reuse the runs
+using TRun_Key = std::tuple<size_t, size_t, GUID, size_t, size_t, uint64_t, uint64_t>;	//problem ordinal, problem size, solver, population size, repetition, shift fingerprint, limits fingerprint
+
+//identifies a deterministic computation, i.e., all the repetitions of a deterministic solver on the same instance give the same run
+using TDeterministic_Key = std::tuple<GUID, std::string, size_t, size_t, uint64_t, uint64_t, uint64_t>;	//solver, problem name, problem size, population size, shift fingerprint, build hash, limits fingerprint
+
+TRun_Key Run_Key(const TRun_Record &record);
+TDeterministic_Key Deterministic_Key(const TRun_Record &record);
+uint64_t Cell_Hash(const TRun_Record &record, const bool whole_instance);	//stable across machines; whole_instance ignores the repetition
+uint64_t Shift_Fingerprint(const CSolution &optimum, const double optimum_fitness);	//FNV-1a of the optimum's bit pattern
+uint64_t Build_Hash(const std::string &build_description);	//FNV-1a, never 0
+uint64_t Limits_Fingerprint(const TRun_Record &record);	//FNV-1a of max_generations, the budget and the distributed worker count
+
+void Replay_Run_Record(const TRun_Record &source, TRun_Record &record);	//copies the source's outcome, but keeps the record's identity, e.g., its repetition
+
+//one record per line, fields as name=value pairs separated by tabs, terminated with a checksum of the line
+std::string Serialize_Run_Record(const TRun_Record &record);
+bool Deserialize_Run_Record(const std::string &line, TRun_Record &record);	//false for a corrupted, e.g., torn, line
+
+
+//Append-only store of the completed runs, which survives crashes and restarts of a campaign.
+//As a sink, it writes each run once it completes; Find then allows to skip the already completed cells.
+class CResult_Store : public IResult_Sink {
+protected:
+	std::mutex mLock;
+	std::string mFile_Name;
+	std::ofstream mFile;
+	std::map<TRun_Key, TRun_Record> mRecords;
+	std::map<TDeterministic_Key, TRun_Record> mDeterministic_Records;	//successful and completed runs with a known build only, i.e., not cut short by a budget
+
+	void Insert(const TRun_Record &record);
+	size_t mCorrupted_Lines = 0;
+public:
+	CResult_Store(const std::string &file_name, const bool writable = true);
+	bool Is_Open() const;
+
+	size_t Record_Count() const;
+	size_t Corrupted_Line_Count() const;
+	bool Find(TRun_Record &record);	//looks up the record's key; on success, replaces the record with the stored one
+	bool Find_Deterministic(TRun_Record &record);	//looks up the record's deterministic key; on success, replays the stored run into the record
+	std::vector<TRun_Record> Records() const;
+
+	virtual void Append_Run(const TRun_Record &record) override;
+};
+
+//prints a summary of a store, optionally compared to another store, without running anything
+void Query_Result_Stores(const std::string &store_file, const std::string &other_store_file);
+
+//combines the stores of the shards of a campaign into the very same report as Evaluate_Solvers produces
+void Merge_Result_Stores(const std::vector<std::string> &store_files, const TCampaign_Options &options);
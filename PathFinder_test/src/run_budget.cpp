@@ -0,0 +1,147 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "run_budget.h"
+
+#include <cmath>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+namespace {
+	const char* Stop_Reason_Names[] = { "completed", "time", "evaluations", "target" };
+}
+
+void Cancel_Solver(solver::TSolver_Progress &progress) {
+#ifdef _MSC_VER
+	_InterlockedExchange(reinterpret_cast<volatile long*>(&progress.cancelled), TRUE);
+#else
+	__atomic_store_n(&progress.cancelled, TRUE, __ATOMIC_RELEASE);
+#endif
+}
+
+bool Is_Solver_Cancelled(const solver::TSolver_Progress &progress) {
+#ifdef _MSC_VER
+	return _InterlockedOr(reinterpret_cast<volatile long*>(const_cast<BOOL*>(&progress.cancelled)), 0) != FALSE;
+#else
+	return __atomic_load_n(&progress.cancelled, __ATOMIC_ACQUIRE) != FALSE;
+#endif
+}
+
+const char* Stop_Reason_Name(const NStop_Reason reason) {
+	return reason < NStop_Reason::count ? Stop_Reason_Names[static_cast<size_t>(reason)] : "unknown";
+}
+
+NStop_Reason Stop_Reason_From_Name(const std::string &name) {
+	for (size_t i = 0; i < static_cast<size_t>(NStop_Reason::count); i++)
+		if (name == Stop_Reason_Names[i]) return static_cast<NStop_Reason>(i);
+
+	return NStop_Reason::Completed;
+}
+
+bool TRun_Budget::Is_Limited() const {
+	return (seconds > 0.0) || (evaluations > 0) || !std::isnan(target_epsilon);
+}
+
+
+CRun_Watchdog::CRun_Watchdog(solver::TSolver_Progress &progress, const TRun_Budget &budget, const TObjective_Context *objective, const double optimum_fitness) :
+	mProgress(progress), mBudget(budget), mObjective(objective),
+	mTarget_Fitness(std::isnan(budget.target_epsilon) ? -std::numeric_limits<double>::infinity() : optimum_fitness + budget.target_epsilon),
+	mStart(std::chrono::steady_clock::now()) {
+
+	if (mBudget.Is_Limited())
+		mThread = std::thread{ &CRun_Watchdog::Watch, this };
+}
+
+CRun_Watchdog::~CRun_Watchdog() {
+	Stop();
+}
+
+NStop_Reason CRun_Watchdog::Check() const {
+	if (mBudget.seconds > 0.0) {
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+		if (elapsed.count() >= mBudget.seconds) return NStop_Reason::Time_Budget;
+	}
+
+	if (mObjective) {
+		if ((mBudget.evaluations > 0) && (mObjective->calls.load(std::memory_order_relaxed) >= mBudget.evaluations)) return NStop_Reason::Evaluation_Budget;
+		if (mObjective->trace.Best() <= mTarget_Fitness) return NStop_Reason::Target_Reached;
+	}
+	else if ((mProgress.current_progress > 0) && (mProgress.best_metric[0] <= mTarget_Fitness))	//the solver's own report, a racy read of a plain double as the UI does
+		return NStop_Reason::Target_Reached;
+
+	return NStop_Reason::Completed;
+}
+
+void CRun_Watchdog::Watch() {
+	std::unique_lock<std::mutex> lock{ mLock };
+	while (!mStopping) {
+		NStop_Reason reason = Check();
+		if ((reason == NStop_Reason::Completed) && mCancel_Requested) reason = NStop_Reason::Evaluation_Budget;	//the objective's only reason to cancel
+		if (reason != NStop_Reason::Completed) {
+			mStop_Reason = reason;
+			Cancel_Solver(mProgress);
+			return;
+		}
+
+		mWake.wait_for(lock, Poll_Period, [this] { return mStopping || mCancel_Requested; });
+	}
+}
+
+void CRun_Watchdog::Request_Cancel() {
+	if (mCancel_Requested.load(std::memory_order_relaxed)) return;	//each call past the budget asks again
+
+	mCancel_Requested = true;
+	mWake.notify_all();
+}
+
+NStop_Reason CRun_Watchdog::Stop() {
+	{
+		std::lock_guard<std::mutex> lock{ mLock };
+		mStopping = true;
+	}
+	mWake.notify_all();
+	if (mThread.joinable()) mThread.join();
+
+	//the solver may have returned before the thread has handled the objective's request, see TObjective_Context::evaluation_budget
+	if ((mStop_Reason == NStop_Reason::Completed) && mCancel_Requested)
+		mStop_Reason = NStop_Reason::Evaluation_Budget;
+
+	return mStop_Reason;
+}
@@ -0,0 +1,105 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <scgms/rtl/SolverLib.h>
+
+#include "objective.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+enum class NStop_Reason : size_t {
+	Completed = 0,		//the solver has finished on its own, e.g., after max_generations
+	Time_Budget,
+	Evaluation_Budget,
+	Target_Reached,		//fitness <= optimum fitness + target epsilon
+	count
+};
+
+//TSolver_Progress::cancelled is a plain BOOL, which the solvers poll from their own threads; our threads access it atomically
+void Cancel_Solver(solver::TSolver_Progress &progress);
+bool Is_Solver_Cancelled(const solver::TSolver_Progress &progress);
+
+const char* Stop_Reason_Name(const NStop_Reason reason);
+NStop_Reason Stop_Reason_From_Name(const std::string &name);	//Completed for an unknown name
+
+//per-run limits, besides the solver's max_generations
+struct TRun_Budget {
+	double seconds = 0.0;			//wall-clock, 0 - unlimited
+	uint64_t evaluations = 0;		//objective calls, 0 - unlimited
+	double target_epsilon = std::numeric_limits<double>::quiet_NaN();	//NaN - no target
+
+	bool Is_Limited() const;
+};
+
+//Enforces a run's budget from its own thread by setting TSolver_Progress::cancelled, which the solvers poll cooperatively.
+//The thread is the flag's only writer, the objective running on the solver's threads asks it to cancel through Request_Cancel.
+//Thus, a solver stops at its next poll, i.e., it may overshoot the budget a bit; the consumed budget is to be measured, not assumed.
+class CRun_Watchdog {
+protected:
+	static constexpr std::chrono::milliseconds Poll_Period{ 5 };
+
+	solver::TSolver_Progress &mProgress;
+	const TRun_Budget mBudget;
+	const TObjective_Context *mObjective;	//nullptr, if the objective is evaluated remotely; then only the time and the progress' best metric are watched
+	const double mTarget_Fitness;
+	const std::chrono::steady_clock::time_point mStart;
+
+	std::atomic<NStop_Reason> mStop_Reason{ NStop_Reason::Completed };
+	std::atomic<bool> mCancel_Requested{ false };	//by the objective, once the evaluation budget is exhausted
+	std::mutex mLock;
+	std::condition_variable mWake;
+	bool mStopping = false;
+	std::thread mThread;
+
+	NStop_Reason Check() const;
+	void Watch();
+public:
+	CRun_Watchdog(solver::TSolver_Progress &progress, const TRun_Budget &budget, const TObjective_Context *objective, const double optimum_fitness);
+	~CRun_Watchdog();
+
+	void Request_Cancel();	//thread-safe, wakes the watchdog's thread to cancel the solver
+	NStop_Reason Stop();	//once the solver has returned; joins the thread and tells why the solver has stopped
+};
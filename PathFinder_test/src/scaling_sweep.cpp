@@ -0,0 +1,238 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "scaling_sweep.h"
+
+#include <scgms/utils/string_utils.h>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <algorithm>
+
+std::vector<size_t> Geometric_Problem_Sizes(const size_t min_size, const size_t max_size, const double factor) {
+	std::vector<size_t> sizes;
+	if ((min_size == 0) || (max_size < min_size) || !(factor > 1.0)) return sizes;
+
+	for (double size = static_cast<double>(min_size); size < static_cast<double>(max_size); size *= factor) {
+		const size_t rounded = static_cast<size_t>(std::llround(size));
+		if (sizes.empty() || (sizes.back() < rounded)) sizes.push_back(rounded);
+	}
+	if (sizes.empty() || (sizes.back() < max_size)) sizes.push_back(max_size);
+
+	return sizes;
+}
+
+bool Parse_Size_Sweep(const std::string &text, std::vector<size_t> &sizes) {
+	const auto first = text.find(':');
+	if (first == std::string::npos) return false;
+	const auto second = text.find(':', first + 1);
+
+	char *end = nullptr;
+	const size_t min_size = std::strtoull(text.c_str(), &end, 10);
+	if (end != text.c_str() + first) return false;
+
+	const std::string max_text = text.substr(first + 1, second == std::string::npos ? std::string::npos : second - first - 1);
+	const size_t max_size = std::strtoull(max_text.c_str(), &end, 10);
+	if (max_text.empty() || (*end != 0)) return false;
+
+	double factor = 2.0;
+	if (second != std::string::npos) {
+		factor = std::strtod(text.c_str() + second + 1, &end);
+		if (*end != 0) return false;
+	}
+
+	sizes = Geometric_Problem_Sizes(min_size, max_size, factor);
+	return !sizes.empty();
+}
+
+double TScaling_Fit::Predict(const double size) const {
+	return coefficient * std::pow(size, exponent);
+}
+
+TScaling_Fit Fit_Power_Law(const std::vector<double> &sizes, const std::vector<double> &values) {
+	TScaling_Fit fit;
+
+	std::vector<double> x, y;
+	for (size_t i = 0; i < std::min(sizes.size(), values.size()); i++) {
+		if ((sizes[i] > 0.0) && (values[i] > 0.0) && std::isfinite(values[i])) {
+			x.push_back(std::log(sizes[i]));
+			y.push_back(std::log(values[i]));
+		}
+	}
+	fit.points = x.size();
+	if (fit.points < 2) return fit;
+
+	const double n = static_cast<double>(fit.points);
+	double x_mean = 0.0, y_mean = 0.0;
+	for (size_t i = 0; i < x.size(); i++) {
+		x_mean += x[i];
+		y_mean += y[i];
+	}
+	x_mean /= n;
+	y_mean /= n;
+
+	double sxx = 0.0, sxy = 0.0, syy = 0.0;
+	for (size_t i = 0; i < x.size(); i++) {
+		sxx += (x[i] - x_mean) * (x[i] - x_mean);
+		sxy += (x[i] - x_mean) * (y[i] - y_mean);
+		syy += (y[i] - y_mean) * (y[i] - y_mean);
+	}
+	if (sxx <= 0.0) return fit;	//a single size only
+
+	fit.exponent = sxy / sxx;
+	fit.coefficient = std::exp(y_mean - fit.exponent * x_mean);
+	fit.r2 = syy > 0.0 ? (sxy * sxy) / (sxx * syy) : 1.0;	//constant values are fitted exactly
+
+	return fit;
+}
+
+namespace {
+	struct TScaling_Series {
+		std::wstring name;
+		GUID solver_id;
+		std::vector<double> sizes, seconds, calls, calls_001;	//medians of the runs
+	};
+
+	struct TProblem_Scaling {
+		std::string name;
+		std::map<std::wstring, TScaling_Series> series;	//by the result name, i.e., the solver and its population size
+		std::vector<GUID> solvers;	//in the order of the first run
+		std::map<GUID, size_t> stopped;	//solver, the first problem size it has not run on
+	};
+
+	void Print_Scaling(const TProblem_Scaling &scaling) {
+		std::cout << std::endl << "--=== Scaling of the solvers on " << scaling.name << " ===--" << std::endl;
+
+		std::cout << "solver; problem size; median seconds; median objective calls; median least objective call 001" << std::endl;
+		std::cout.precision(3);
+		std::cout << std::scientific;
+		for (const auto &series : scaling.series) {
+			for (size_t i = 0; i < series.second.sizes.size(); i++)
+				std::cout << Narrow_WString(series.first) << "; " << static_cast<size_t>(series.second.sizes[i]) << "; " << series.second.seconds[i] << "; " << series.second.calls[i] << "; " << series.second.calls_001[i] << std::endl;
+		}
+
+		std::cout << std::endl << "solver; sizes; seconds exponent; R2; objective calls exponent; R2; least objective call 001 exponent; R2; stopped before size" << std::endl;
+		for (const auto &series : scaling.series) {
+			const auto seconds = Fit_Power_Law(series.second.sizes, series.second.seconds);
+			const auto calls = Fit_Power_Law(series.second.sizes, series.second.calls);
+			const auto calls_001 = Fit_Power_Law(series.second.sizes, series.second.calls_001);
+			const auto stopped = scaling.stopped.find(series.second.solver_id);
+
+			std::cout << Narrow_WString(series.first) << "; " << series.second.sizes.size() << "; "
+					  << seconds.exponent << "; " << seconds.r2 << "; " << calls.exponent << "; " << calls.r2 << "; " << calls_001.exponent << "; " << calls_001.r2 << "; ";
+			if (stopped != scaling.stopped.end()) std::cout << stopped->second;
+			std::cout << std::endl;
+		}
+	}
+}
+
+void Sweep_Problem_Sizes(const TCampaign_Spec &spec, const TCampaign_Options &options) {
+	std::map<size_t, TProblem_Scaling> problems;	//by the problem ordinal number
+
+	for (size_t size_index = 0; size_index < spec.problem_sizes.size(); size_index++) {
+		const size_t size = spec.problem_sizes[size_index];
+		const auto collection = Create_Problem_Collection(size);
+
+		std::vector<std::string> problem_names;
+		for (const auto &problem : collection)
+			problem_names.push_back(problem->Get_Name());
+
+		for (const size_t problem_number : spec.Selected_Problems(problem_names)) {
+			CCommon_Problem *problem = collection[problem_number].get();
+			TProblem_Scaling &scaling = problems[problem_number];
+			scaling.name = problem_names[problem_number];
+
+			if (!problem->Can_Be_Solved()) {
+				std::cout << "Skipping " << scaling.name << " with problem size = " << size << ", which cannot be solved." << std::endl;
+				continue;
+			}
+
+			//once the solvers are known, the stopped and the faulty ones are left out
+			TCampaign_Options size_options = options;
+			if (!scaling.solvers.empty()) {
+				size_options.solvers.clear();
+				for (const auto &solver_id : scaling.solvers) {
+					if (scaling.stopped.find(solver_id) != scaling.stopped.end()) continue;
+					if (Is_Solver_Faulty(solver_id, size)) {
+						scaling.stopped[solver_id] = size;
+						continue;
+					}
+					size_options.solvers.push_back(GUID_To_WString(solver_id));
+				}
+
+				if (size_options.solvers.empty()) {
+					std::cout << "All the solvers have stopped the sweep of " << scaling.name << " before problem size = " << size << "." << std::endl;
+					continue;
+				}
+			}
+
+			auto results = Evaluate_Solvers(problem, spec.repetitions, problem_number, size_options);
+
+			const double next_size = size_index + 1 < spec.problem_sizes.size() ? static_cast<double>(spec.problem_sizes[size_index + 1]) : std::numeric_limits<double>::quiet_NaN();
+			for (const auto &result : results) {
+				if (std::find(scaling.solvers.begin(), scaling.solvers.end(), result.solver_id) == scaling.solvers.end())
+					scaling.solvers.push_back(result.solver_id);
+				if (result.seconds.empty()) continue;	//all the runs have failed
+
+				auto &series = scaling.series[result.name];
+				series.name = result.name;
+				series.solver_id = result.solver_id;
+				series.sizes.push_back(static_cast<double>(size));
+				series.seconds.push_back(result.seconds.Get_Stats().med);
+				series.calls.push_back(result.total_objective_calls.Get_Stats().med);
+				series.calls_001.push_back(result.least_objective_call_001.Get_Stats().med);
+
+				//any population size over the budget stops the solver
+				const auto fit = Fit_Power_Law(series.sizes, series.seconds);
+				const bool over_budget = (series.seconds.back() > options.sweep_budget_seconds) || (fit.points >= 2 && fit.Predict(next_size) > options.sweep_budget_seconds);
+				if (over_budget && std::isfinite(next_size) && (scaling.stopped.find(result.solver_id) == scaling.stopped.end())) {
+					std::wcout << L"Solver " << result.name << L" exceeds the sweep budget, it stops after problem size = " << size << std::endl;
+					scaling.stopped[result.solver_id] = static_cast<size_t>(next_size);
+				}
+			}
+		}
+	}
+
+	for (const auto &problem : problems)
+		Print_Scaling(problem.second);
+
+	std::cout << std::endl << "--=== Problem size sweep completed. ===--" << std::endl << std::endl;
+}
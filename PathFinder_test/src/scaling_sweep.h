@@ -0,0 +1,68 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "campaign_spec.h"
+
+#include <string>
+#include <vector>
+
+//min, min*factor, min*factor^2, ... up to and including max; rounded and without duplicates
+std::vector<size_t> Geometric_Problem_Sizes(const size_t min_size, const size_t max_size, const double factor);
+
+//parses "min:max[:factor]", the factor defaults to 2
+bool Parse_Size_Sweep(const std::string &text, std::vector<size_t> &sizes);
+
+//value = coefficient * size^exponent, fitted by the least squares in the log-log space
+struct TScaling_Fit {
+	double exponent = std::numeric_limits<double>::quiet_NaN();
+	double coefficient = std::numeric_limits<double>::quiet_NaN();
+	double r2 = std::numeric_limits<double>::quiet_NaN();
+	size_t points = 0;	//the positive, finite values only; at least two distinct sizes are needed for a fit
+
+	double Predict(const double size) const;
+};
+
+TScaling_Fit Fit_Power_Law(const std::vector<double> &sizes, const std::vector<double> &values);
+
+//Evaluates the solvers on each of the spec's problem sizes and reports the empirical complexity of each solver,
+//i.e., the exponents of the median seconds, total objective calls and least objective calls to 1% of the optimum.
+//A solver is not run on the larger sizes once it is faulty for the size, or its median run exceeds,
+//or is predicted to exceed at the next size, options.sweep_budget_seconds.
+void Sweep_Problem_Sizes(const TCampaign_Spec &spec, const TCampaign_Options &options);
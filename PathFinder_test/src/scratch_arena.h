@@ -0,0 +1,78 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "TProblemData.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+//Thread-local scratch buffers of the objective's hot path.
+//Each buffer grows to the largest size requested on its thread and is reused then, i.e., the steady state does not allocate.
+enum class NScratch_Buffer : size_t {
+	Real_Calls = 0,	//per candidate of a batch, whether it has reached the problem, or hit the cache
+	count
+};
+
+namespace scratch {
+	using TBuffers = std::array<std::vector<unsigned char>, static_cast<size_t>(NScratch_Buffer::count)>;
+	TBuffers& Thread_Buffers();
+}
+
+//count elements of T; the contents are not preserved across the calls
+template <typename T>
+T* Thread_Scratch(const NScratch_Buffer buffer, const size_t count) {
+	auto &bytes = scratch::Thread_Buffers()[static_cast<size_t>(buffer)];
+	if (bytes.size() < count * sizeof(T)) bytes.resize(count * sizeof(T));	//operator new aligns to at least alignof(double)
+	return reinterpret_cast<T*>(bytes.data());
+}
+
+//sizes the calling thread's buffers for batches of up to batch_size candidates in advance
+void Reserve_Thread_Scratch(const size_t batch_size);
+
+//The CSolution temporaries of a run, reused by the runs on the same thread.
+//Eigen does not reallocate, when a vector is assigned or set to its current size, thus only a change of the problem size allocates.
+struct TRun_Solutions {
+	CSolution lower_bound, upper_bound;
+	std::unique_ptr<CSolution> optimum = std::make_unique<CSolution>();
+	CSolution parameters, parameters_001;
+};
+
+TRun_Solutions& Thread_Run_Solutions();
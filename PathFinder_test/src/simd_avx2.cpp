@@ -0,0 +1,91 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+//compiled with -mavx2 -mfma, or /arch:AVX2, see CMakeLists.txt
+
+#include "simd_kernels.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+#include "simd_kernels_impl.h"
+
+namespace {
+	struct TAVX2_Lanes {
+		using V = __m256d;
+		static constexpr size_t Width = 4;
+
+		static V Set(const double value) { return _mm256_set1_pd(value); }
+		static V Iota() { return _mm256_set_pd(3.0, 2.0, 1.0, 0.0); }
+		static V Load(const double *x) { return _mm256_loadu_pd(x); }
+		static V Add(const V a, const V b) { return _mm256_add_pd(a, b); }
+		static V Sub(const V a, const V b) { return _mm256_sub_pd(a, b); }
+		static V Mul(const V a, const V b) { return _mm256_mul_pd(a, b); }
+		static V Div(const V a, const V b) { return _mm256_div_pd(a, b); }
+		static V Fmadd(const V a, const V b, const V c) { return _mm256_fmadd_pd(a, b, c); }
+		static V Fnmadd(const V a, const V b, const V c) { return _mm256_fnmadd_pd(a, b, c); }
+		static V Sqrt(const V a) { return _mm256_sqrt_pd(a); }
+		static V Round(const V a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static V Floor(const V a) { return _mm256_floor_pd(a); }
+		static V Cmp_Gt(const V a, const V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+		static V Blend(const V mask, const V if_true, const V if_false) { return _mm256_blendv_pd(if_false, if_true, mask); }
+
+		static double Reduce_Add(const V a) {
+			const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+		}
+
+		static double Reduce_Mul(const V a) {
+			const __m128d pair = _mm_mul_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+			return _mm_cvtsd_f64(_mm_mul_sd(pair, _mm_unpackhi_pd(pair, pair)));
+		}
+	};
+}
+
+const TKernel_Table* AVX2_Kernel_Table() {
+	return Make_Kernel_Table<TAVX2_Lanes>();
+}
+
+#else
+
+const TKernel_Table* AVX2_Kernel_Table() {
+	return nullptr;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+//compiled with -mavx512f, or /arch:AVX512, see CMakeLists.txt
+
+#include "simd_kernels.h"
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+#include "simd_kernels_impl.h"
+
+namespace {
+	struct TAVX512_Lanes {
+		using V = __m512d;
+		static constexpr size_t Width = 8;
+
+		static V Set(const double value) { return _mm512_set1_pd(value); }
+		static V Iota() { return _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0); }
+		static V Load(const double *x) { return _mm512_loadu_pd(x); }
+		static V Add(const V a, const V b) { return _mm512_add_pd(a, b); }
+		static V Sub(const V a, const V b) { return _mm512_sub_pd(a, b); }
+		static V Mul(const V a, const V b) { return _mm512_mul_pd(a, b); }
+		static V Div(const V a, const V b) { return _mm512_div_pd(a, b); }
+		static V Fmadd(const V a, const V b, const V c) { return _mm512_fmadd_pd(a, b, c); }
+		static V Fnmadd(const V a, const V b, const V c) { return _mm512_fnmadd_pd(a, b, c); }
+		static V Sqrt(const V a) { return _mm512_sqrt_pd(a); }
+		static V Round(const V a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+		static V Floor(const V a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+		static __mmask8 Cmp_Gt(const V a, const V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+		static V Blend(const __mmask8 mask, const V if_true, const V if_false) { return _mm512_mask_blend_pd(mask, if_false, if_true); }
+
+		static double Reduce_Add(const V a) { return _mm512_reduce_add_pd(a); }
+		static double Reduce_Mul(const V a) { return _mm512_reduce_mul_pd(a); }
+	};
+}
+
+const TKernel_Table* AVX512_Kernel_Table() {
+	return Make_Kernel_Table<TAVX512_Lanes>();
+}
+
+#else
+
+const TKernel_Table* AVX512_Kernel_Table() {
+	return nullptr;
+}
+
+#endif
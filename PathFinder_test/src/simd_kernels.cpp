@@ -0,0 +1,385 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "simd_kernels.h"
+#include "TProblemData.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+#endif
+
+namespace {
+
+	//the scalar reference, written as the functions are usually defined
+	namespace reference {
+		constexpr double Two_Pi = 6.28318530717958647692;
+
+		double Sphere(const double *x, const size_t n) {
+			double sum = 0.0;
+			for (size_t i = 0; i < n; i++)
+				sum += x[i] * x[i];
+			return sum;
+		}
+
+		double Ellipsoid(const double *x, const size_t n) {
+			double sum = 0.0;
+			for (size_t i = 0; i < n; i++)
+				sum += static_cast<double>(i + 1) * x[i] * x[i];
+			return sum;
+		}
+
+		double Rosenbrock(const double *x, const size_t n) {
+			double sum = 0.0;
+			for (size_t i = 0; i + 1 < n; i++) {
+				const double valley = x[i + 1] - x[i] * x[i];
+				const double slope = 1.0 - x[i];
+				sum += 100.0 * valley * valley + slope * slope;
+			}
+			return sum;
+		}
+
+		double Rastrigin(const double *x, const size_t n) {
+			double sum = 0.0;
+			for (size_t i = 0; i < n; i++)
+				sum += x[i] * x[i] + 10.0 * (1.0 - std::cos(Two_Pi * x[i]));
+			return sum;
+		}
+
+		double Griewank(const double *x, const size_t n) {
+			double sum = 0.0;
+			double prod = 1.0;
+			for (size_t i = 0; i < n; i++) {
+				sum += x[i] * x[i];
+				prod *= std::cos(x[i] / std::sqrt(static_cast<double>(i + 1)));
+			}
+			return 1.0 + sum / 4000.0 - prod;
+		}
+
+		double Ackley(const double *x, const size_t n) {
+			if (n == 0) return 0.0;
+
+			double square_sum = 0.0;
+			double cos_sum = 0.0;
+			for (size_t i = 0; i < n; i++) {
+				square_sum += x[i] * x[i];
+				cos_sum += std::cos(Two_Pi * x[i]);
+			}
+
+			const double dn = static_cast<double>(n);
+			return 20.0 + 2.71828182845904523536 - 20.0 * std::exp(-0.2 * std::sqrt(square_sum / dn)) - std::exp(cos_sum / dn);
+		}
+
+		const TKernel_Table table = { &Sphere, &Ellipsoid, &Rosenbrock, &Rastrigin, &Griewank, &Ackley };
+	}
+
+	const std::array<TBenchmark_Function_Info, static_cast<size_t>(NBenchmark_Function::count)> Function_Infos = { {
+		{ "sphere", -100.0, 100.0, 0.0 },
+		{ "ellipsoid", -100.0, 100.0, 0.0 },
+		{ "rosenbrock", -30.0, 30.0, 1.0 },
+		{ "rastrigin", -5.12, 5.12, 0.0 },
+		{ "griewank", -600.0, 600.0, 0.0 },
+		{ "ackley", -32.768, 32.768, 0.0 },
+	} };
+
+	//a point of the domain, or near the optimum at the given relative radius, with the radius 0 for a uniform point
+	void Sample_Point(std::vector<double> &point, const TBenchmark_Function_Info &info, const double radius, std::mt19937_64 &random_generator) {
+		std::uniform_real_distribution<double> uniform{ info.lower_bound, info.upper_bound };
+		std::uniform_real_distribution<double> offset{ -1.0, 1.0 };
+		const double width = info.upper_bound - info.lower_bound;
+		for (auto &x : point)
+			x = radius > 0.0 ? info.optimum + radius * width * offset(random_generator) : uniform(random_generator);
+	}
+
+	bool Equal_Names(const std::string &a, const char *b) {
+		if (a.size() != std::strlen(b)) return false;
+		for (size_t i = 0; i < a.size(); i++)
+			if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+		return true;
+	}
+
+	//The kernels are not the problem collection's implementation, thus each of them is compared to the collection's problem of the same name,
+	//whose optimum may be shifted. Returns the number of kernels differing from their problem beyond the relative tolerance.
+	size_t Verify_Against_Problem_Collection(const TKernel_Table &kernels, const double tolerance) {
+		const std::vector<size_t> dimensions = { 2, 10, 100 };
+		const std::vector<double> radii = { 0.0, 1e-1, 1e-3, 1e-6, 1e-9 };	//0.0 - uniform within the problem's bounds
+		const size_t points_per_radius = 100;
+
+		std::cout << "function; dimension; max relative difference to the problem collection" << std::endl;
+
+		size_t failed = 0;
+		std::mt19937_64 random_generator{ 20181 };
+		for (size_t f = 0; f < static_cast<size_t>(NBenchmark_Function::count); f++) {
+			const auto &info = Function_Infos[f];
+
+			for (const size_t dimension : dimensions) {
+				const auto problems = Create_Problem_Collection(dimension);
+				const auto problem = std::find_if(problems.begin(), problems.end(), [&info](const auto &candidate) { return Equal_Names(candidate->Get_Name(), info.name); });
+				if (problem == problems.end()) {
+					std::cout << info.name << "; " << dimension << "; no such problem in the collection, the kernel is unverified against it" << std::endl;
+					continue;
+				}
+
+				CSolution lower_bound, upper_bound, optimum;
+				double optimum_fitness;
+				(*problem)->get_bounds(lower_bound, upper_bound);
+				(*problem)->get_optimum(optimum, optimum_fitness);
+
+				std::vector<double> x(dimension), z(dimension);
+				double worst = 0.0;
+				for (const double radius : radii) {
+					for (size_t p = 0; p < points_per_radius; p++) {
+						for (size_t d = 0; d < dimension; d++) {
+							const double width = upper_bound[d] - lower_bound[d];
+							x[d] = radius > 0.0 ? optimum[d] + radius * width * std::uniform_real_distribution<double>{ -1.0, 1.0 }(random_generator)
+												: std::uniform_real_distribution<double>{ lower_bound[d], upper_bound[d] }(random_generator);
+							z[d] = x[d] - optimum[d] + info.optimum;	//the kernel's own, unshifted, coordinates
+						}
+
+						const double expected = (*problem)->Calculate_Fitness(x.data());
+						const double difference = std::fabs(kernels[f](z.data(), dimension) + optimum_fitness - expected) / std::max(1.0, std::fabs(expected));
+						if (!(difference <= worst)) worst = difference;	//NaN as well
+					}
+				}
+				(*problem)->reset_counters();
+
+				const bool ok = worst <= tolerance;
+				if (!ok) failed++;
+				std::cout << info.name << "; " << dimension << "; " << worst << (ok ? "" : "; differs from the problem collection") << std::endl;
+			}
+		}
+
+		return failed;
+	}
+
+	bool CPU_Supports(const NSIMD_Level level) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		switch (level) {
+			case NSIMD_Level::Scalar: return true;
+			case NSIMD_Level::SSE42: return __builtin_cpu_supports("sse4.2");
+			case NSIMD_Level::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+			case NSIMD_Level::AVX512: return __builtin_cpu_supports("avx512f");
+			default: return false;
+		}
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int regs[4];
+		__cpuid(regs, 0);
+		const int max_leaf = regs[0];
+
+		__cpuid(regs, 1);
+		const bool sse42 = (regs[2] & (1 << 20)) != 0;
+		const bool fma = (regs[2] & (1 << 12)) != 0;
+		const bool osxsave = (regs[2] & (1 << 27)) != 0;
+		const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+		const bool os_avx = (xcr0 & 0x6) == 0x6;
+		const bool os_avx512 = (xcr0 & 0xE6) == 0xE6;
+
+		int ext[4] = { 0, 0, 0, 0 };
+		if (max_leaf >= 7) __cpuidex(ext, 7, 0);
+		const bool avx2 = (ext[1] & (1 << 5)) != 0;
+		const bool avx512f = (ext[1] & (1 << 16)) != 0;
+
+		switch (level) {
+			case NSIMD_Level::Scalar: return true;
+			case NSIMD_Level::SSE42: return sse42;
+			case NSIMD_Level::AVX2: return avx2 && fma && os_avx;
+			case NSIMD_Level::AVX512: return avx512f && os_avx512;
+			default: return false;
+		}
+#else
+		return level == NSIMD_Level::Scalar;
+#endif
+	}
+
+	const TKernel_Table* Compiled_Kernel_Table(const NSIMD_Level level) {
+		switch (level) {
+			case NSIMD_Level::Scalar: return &reference::table;
+			case NSIMD_Level::SSE42: return SSE42_Kernel_Table();
+			case NSIMD_Level::AVX2: return AVX2_Kernel_Table();
+			case NSIMD_Level::AVX512: return AVX512_Kernel_Table();
+			default: return nullptr;
+		}
+	}
+
+	//distance of two doubles in units in the last place, the sign is folded so that -0.0 and 0.0 are adjacent
+	double ULP_Distance(const double a, const double b) {
+		if (std::isnan(a) || std::isnan(b)) return (std::isnan(a) && std::isnan(b)) ? 0.0 : std::numeric_limits<double>::infinity();
+
+		auto ordered = [](const double value) {
+			int64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return bits < 0 ? std::numeric_limits<int64_t>::min() - bits : bits;
+		};
+
+		const int64_t ia = ordered(a), ib = ordered(b);
+		return ia > ib ? static_cast<double>(static_cast<uint64_t>(ia) - static_cast<uint64_t>(ib)) : static_cast<double>(static_cast<uint64_t>(ib) - static_cast<uint64_t>(ia));
+	}
+}
+
+const TBenchmark_Function_Info& Benchmark_Function_Info(const NBenchmark_Function function) {
+	return Function_Infos[static_cast<size_t>(function)];
+}
+
+const char* SIMD_Level_Name(const NSIMD_Level level) {
+	switch (level) {
+		case NSIMD_Level::Scalar: return "scalar";
+		case NSIMD_Level::SSE42: return "sse4.2";
+		case NSIMD_Level::AVX2: return "avx2";
+		case NSIMD_Level::AVX512: return "avx512";
+		default: return "unknown";
+	}
+}
+
+const TKernel_Table* Kernel_Table(const NSIMD_Level level) {
+	return CPU_Supports(level) ? Compiled_Kernel_Table(level) : nullptr;
+}
+
+NSIMD_Level Supported_SIMD_Level() {
+	for (size_t i = static_cast<size_t>(NSIMD_Level::count); i-- > 0; ) {
+		const NSIMD_Level level = static_cast<NSIMD_Level>(i);
+		if (Kernel_Table(level)) return level;
+	}
+
+	return NSIMD_Level::Scalar;
+}
+
+const TKernel_Table& Benchmark_Kernels() {
+	static const TKernel_Table &dispatched = *Kernel_Table(Supported_SIMD_Level());
+	return dispatched;
+}
+
+size_t Verify_SIMD_Kernels(const double max_ulp) {
+	const std::vector<size_t> dimensions = { 1, 2, 3, 5, 7, 8, 13, 16, 31, 64, 100, 1000 };
+	const size_t points_per_dimension = 1000;
+	const size_t timing_dimension = 1000;
+	const size_t timing_evaluations = 20'000;
+	const double collection_tolerance = 1e-9;	//relative; the shifted coordinates of the collection's problems round differently, thus no ULP bound
+	const std::vector<double> near_optimum_radii = { 0.0, 0.0, 0.0, 0.0, 1e-1, 1e-3, 1e-6, 1e-9 };	//half of the points uniform, the rest near the optimum
+	const double near_optimum_tolerance = 1e-13;	//absolute below 1, relative above it
+
+	std::cout << "Dispatched SIMD level: " << SIMD_Level_Name(Supported_SIMD_Level()) << std::endl;
+	std::cout << "function; level; max ulp; worst dimension; max error near the optimum; ns per evaluation at dimension " << timing_dimension << "; speedup" << std::endl;
+
+	size_t failed = 0;
+	std::mt19937_64 random_generator{ 20181 };
+	std::vector<double> points;
+	volatile double sink = 0.0;	//keeps the timed evaluations alive
+
+	for (size_t f = 0; f < static_cast<size_t>(NBenchmark_Function::count); f++) {
+		const auto &info = Function_Infos[f];
+		std::uniform_real_distribution<double> uniform{ info.lower_bound, info.upper_bound };
+
+		double scalar_ns = std::numeric_limits<double>::quiet_NaN();
+
+		for (size_t l = 0; l < static_cast<size_t>(NSIMD_Level::count); l++) {
+			const NSIMD_Level level = static_cast<NSIMD_Level>(l);
+			const TKernel_Table *table = Kernel_Table(level);
+			if (!table) {
+				std::cout << info.name << "; " << SIMD_Level_Name(level) << "; not available" << std::endl;
+				continue;
+			}
+
+			const TBenchmark_Kernel kernel = (*table)[f];
+			const TBenchmark_Kernel scalar = reference::table[f];
+
+			double worst_ulp = 0.0, worst_near_optimum = 0.0;
+			size_t worst_dimension = 0;
+			random_generator.seed(20181 + f);	//the same points for each level
+			for (const size_t dimension : dimensions) {
+				points.resize(dimension);
+				for (size_t p = 0; p < points_per_dimension; p++) {
+					const double radius = near_optimum_radii[p % near_optimum_radii.size()];
+					Sample_Point(points, info, radius, random_generator);
+					const double value = kernel(points.data(), dimension), reference_value = scalar(points.data(), dimension);
+
+					//near the optimum, the value is a cancellation of the terms, which leaves no ULP accuracy to the reference either,
+					//hence the absolute error below 1, as fitness_error is absolute, and the relative one above it
+					if (radius > 0.0) {
+						const double error = std::fabs(value - reference_value) / std::max(1.0, std::fabs(reference_value));
+						if (!(error <= worst_near_optimum)) worst_near_optimum = error;	//NaN as well
+						continue;
+					}
+
+					const double ulp = ULP_Distance(value, reference_value);
+					if (ulp > worst_ulp) {
+						worst_ulp = ulp;
+						worst_dimension = dimension;
+					}
+				}
+			}
+
+			points.resize(timing_dimension);
+			for (auto &x : points) x = uniform(random_generator);
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t e = 0; e < timing_evaluations; e++) {
+				points[e % timing_dimension] += 1e-9;	//defeats hoisting the call out of the loop
+				sink = sink + kernel(points.data(), timing_dimension);
+			}
+			const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			const double ns = elapsed.count() / static_cast<double>(timing_evaluations);
+			if (level == NSIMD_Level::Scalar) scalar_ns = ns;
+
+			const bool ok = (worst_ulp <= max_ulp) && (worst_near_optimum <= near_optimum_tolerance);
+			if (!ok) failed++;
+
+			std::cout << info.name << "; " << SIMD_Level_Name(level) << "; " << worst_ulp << "; " << worst_dimension << "; " << worst_near_optimum << "; "
+				<< ns << "; " << scalar_ns / ns << (ok ? "" : "; exceeds the bounds") << std::endl;
+		}
+	}
+
+	if (failed == 0)
+		std::cout << "All kernels are within " << max_ulp << " ULP of the scalar reference, and within " << near_optimum_tolerance << " near the optimum." << std::endl;
+	else
+		std::cout << failed << " kernel(s) exceed " << max_ulp << " ULP of the scalar reference, or " << near_optimum_tolerance << " near the optimum!" << std::endl;
+
+	std::cout << std::endl;
+	const size_t differing = Verify_Against_Problem_Collection(Benchmark_Kernels(), collection_tolerance);
+	if (differing > 0) std::cout << differing << " kernel(s) differ from the problem collection by more than " << collection_tolerance << "!" << std::endl;
+
+	return failed + differing;
+}
@@ -0,0 +1,89 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+//Vectorized implementations of the standard benchmark functions, selected by the CPU features once at load time.
+//Every level computes the same function as the scalar reference, only the summation order and the cosine approximation differ.
+//The problems of Create_Problem_Collection do not call these kernels; Verify_SIMD_Kernels compares them to the collection's problems of the same names.
+
+enum class NSIMD_Level : size_t {
+	Scalar = 0,
+	SSE42,
+	AVX2,
+	AVX512,
+	count
+};
+
+enum class NBenchmark_Function : size_t {
+	Sphere = 0,
+	Ellipsoid,	//axis parallel hyper-ellipsoid, sum of i*x_i^2
+	Rosenbrock,
+	Rastrigin,
+	Griewank,
+	Ackley,
+	count
+};
+
+using TBenchmark_Kernel = double(*)(const double *x, const size_t n);
+using TKernel_Table = std::array<TBenchmark_Kernel, static_cast<size_t>(NBenchmark_Function::count)>;
+
+struct TBenchmark_Function_Info {
+	const char *name;
+	double lower_bound, upper_bound;	//the usual domain, the same for each dimension
+	double optimum;	//the same for each dimension of the unshifted function
+};
+
+const TBenchmark_Function_Info& Benchmark_Function_Info(const NBenchmark_Function function);
+const char* SIMD_Level_Name(const NSIMD_Level level);
+
+NSIMD_Level Supported_SIMD_Level();	//the best level both compiled in and supported by this CPU
+const TKernel_Table* Kernel_Table(const NSIMD_Level level);	//nullptr, if not compiled in or not supported by this CPU
+const TKernel_Table& Benchmark_Kernels();	//dispatched to the supported level
+
+//Compares every compiled-in level against the scalar reference at random points of each function's domain and near its optimum, and measures their speed.
+//Then compares the dispatched kernels against Calculate_Fitness of the collection's problems. Returns the number of kernels exceeding max_ulp or differing from the collection.
+size_t Verify_SIMD_Kernels(const double max_ulp);
+
+//the per-level tables, nullptr if the level is not compiled in for this architecture
+const TKernel_Table* SSE42_Kernel_Table();
+const TKernel_Table* AVX2_Kernel_Table();
+const TKernel_Table* AVX512_Kernel_Table();
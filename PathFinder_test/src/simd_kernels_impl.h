@@ -0,0 +1,224 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+//Kernels generic over the lanes' traits, included by each per-level translation unit only.
+//Each unit is compiled with its own instruction set, thus everything here has internal linkage
+//so that a wider level's code cannot be merged into a narrower level's unit by the linker.
+
+#include "simd_kernels.h"
+
+#include <cmath>
+
+namespace {
+
+	//Cody-Waite split of pi/2, the first two parts have 33 significant bits so that k*part is exact for |k| < 2^20
+	constexpr double Two_Over_Pi = 6.36619772367581382433e-01;
+	constexpr double Pio2_1 = 1.57079632673412561417e+00;
+	constexpr double Pio2_2 = 6.07710050650619224932e-11;
+	constexpr double Pio2_3 = 2.02226624871116645580e-21;
+
+	//minimax polynomials of sin and cos on [-pi/4, pi/4], as in fdlibm
+	constexpr double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03, S3 = -1.98412698298579493134e-04,
+					 S4 = 2.75573137070700676789e-06, S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+	constexpr double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03, C3 = 2.48015872894767294178e-05,
+					 C4 = -2.75573143513906633035e-07, C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+
+	constexpr double Two_Pi = 6.28318530717958647692;
+
+	template <typename L>
+	typename L::V Cos(const typename L::V x) {
+		using V = typename L::V;
+
+		//x = k*pi/2 + r, |r| <= pi/4
+		const V k = L::Round(L::Mul(x, L::Set(Two_Over_Pi)));
+		V r = L::Fnmadd(k, L::Set(Pio2_1), x);
+		r = L::Fnmadd(k, L::Set(Pio2_2), r);
+		r = L::Fnmadd(k, L::Set(Pio2_3), r);
+
+		const V z = L::Mul(r, r);
+
+		V sin_poly = L::Fmadd(z, L::Set(S6), L::Set(S5));
+		sin_poly = L::Fmadd(z, sin_poly, L::Set(S4));
+		sin_poly = L::Fmadd(z, sin_poly, L::Set(S3));
+		sin_poly = L::Fmadd(z, sin_poly, L::Set(S2));
+		sin_poly = L::Fmadd(z, sin_poly, L::Set(S1));
+		const V sin_r = L::Fmadd(L::Mul(z, r), sin_poly, r);
+
+		V cos_poly = L::Fmadd(z, L::Set(C6), L::Set(C5));
+		cos_poly = L::Fmadd(z, cos_poly, L::Set(C4));
+		cos_poly = L::Fmadd(z, cos_poly, L::Set(C3));
+		cos_poly = L::Fmadd(z, cos_poly, L::Set(C2));
+		cos_poly = L::Fmadd(z, cos_poly, L::Set(C1));
+		const V cos_r = L::Fmadd(L::Mul(z, z), cos_poly, L::Fnmadd(z, L::Set(0.5), L::Set(1.0)));
+
+		//quadrant q = k mod 4: cos, -sin, -cos, sin
+		const V q = L::Sub(k, L::Mul(L::Set(4.0), L::Floor(L::Mul(k, L::Set(0.25)))));
+		const V odd = L::Sub(q, L::Mul(L::Set(2.0), L::Floor(L::Mul(q, L::Set(0.5)))));
+		const V half = L::Floor(L::Mul(L::Add(q, L::Set(1.0)), L::Set(0.5)));
+		const V negative = L::Sub(half, L::Mul(L::Set(2.0), L::Floor(L::Mul(half, L::Set(0.5)))));
+
+		const V value = L::Blend(L::Cmp_Gt(odd, L::Set(0.5)), sin_r, cos_r);
+		return L::Mul(value, L::Fnmadd(negative, L::Set(2.0), L::Set(1.0)));
+	}
+
+	template <typename L>
+	double Sphere(const double *x, const size_t n) {
+		typename L::V acc = L::Set(0.0);
+		size_t i = 0;
+		for (; i + L::Width <= n; i += L::Width) {
+			const auto v = L::Load(x + i);
+			acc = L::Fmadd(v, v, acc);
+		}
+
+		double sum = L::Reduce_Add(acc);
+		for (; i < n; i++)
+			sum += x[i] * x[i];
+		return sum;
+	}
+
+	template <typename L>
+	double Ellipsoid(const double *x, const size_t n) {
+		typename L::V acc = L::Set(0.0);
+		size_t i = 0;
+		for (; i + L::Width <= n; i += L::Width) {
+			const auto v = L::Load(x + i);
+			const auto index = L::Add(L::Iota(), L::Set(static_cast<double>(i + 1)));
+			acc = L::Fmadd(index, L::Mul(v, v), acc);
+		}
+
+		double sum = L::Reduce_Add(acc);
+		for (; i < n; i++)
+			sum += static_cast<double>(i + 1) * x[i] * x[i];
+		return sum;
+	}
+
+	template <typename L>
+	double Rosenbrock(const double *x, const size_t n) {
+		if (n < 2) return 0.0;
+
+		typename L::V acc = L::Set(0.0);
+		size_t i = 0;
+		for (; i + L::Width <= n - 1; i += L::Width) {
+			const auto v = L::Load(x + i);
+			const auto next = L::Load(x + i + 1);
+			const auto valley = L::Fnmadd(v, v, next);
+			const auto slope = L::Sub(L::Set(1.0), v);
+			acc = L::Fmadd(L::Set(100.0), L::Mul(valley, valley), L::Fmadd(slope, slope, acc));
+		}
+
+		double sum = L::Reduce_Add(acc);
+		for (; i < n - 1; i++) {
+			const double valley = x[i + 1] - x[i] * x[i];
+			const double slope = 1.0 - x[i];
+			sum += 100.0 * valley * valley + slope * slope;
+		}
+		return sum;
+	}
+
+	template <typename L>
+	double Rastrigin(const double *x, const size_t n) {
+		//each term is summed as x^2 + 10*(1 - cos), i.e., non-negative, so that the order of summation cannot cancel
+		typename L::V acc = L::Set(0.0);
+		size_t i = 0;
+		for (; i + L::Width <= n; i += L::Width) {
+			const auto v = L::Load(x + i);
+			const auto cos = Cos<L>(L::Mul(v, L::Set(Two_Pi)));
+			acc = L::Fmadd(v, v, L::Fmadd(L::Set(10.0), L::Sub(L::Set(1.0), cos), acc));
+		}
+
+		double sum = L::Reduce_Add(acc);
+		for (; i < n; i++)
+			sum += x[i] * x[i] + 10.0 * (1.0 - std::cos(Two_Pi * x[i]));
+		return sum;
+	}
+
+	template <typename L>
+	double Griewank(const double *x, const size_t n) {
+		typename L::V squares = L::Set(0.0);
+		typename L::V product = L::Set(1.0);
+		size_t i = 0;
+		for (; i + L::Width <= n; i += L::Width) {
+			const auto v = L::Load(x + i);
+			const auto index = L::Add(L::Iota(), L::Set(static_cast<double>(i + 1)));
+			squares = L::Fmadd(v, v, squares);
+			product = L::Mul(product, Cos<L>(L::Div(v, L::Sqrt(index))));
+		}
+
+		double sum = L::Reduce_Add(squares);
+		double prod = L::Reduce_Mul(product);
+		for (; i < n; i++) {
+			sum += x[i] * x[i];
+			prod *= std::cos(x[i] / std::sqrt(static_cast<double>(i + 1)));
+		}
+		return 1.0 + sum / 4000.0 - prod;
+	}
+
+	template <typename L>
+	double Ackley(const double *x, const size_t n) {
+		if (n == 0) return 0.0;
+
+		typename L::V squares = L::Set(0.0);
+		typename L::V cosines = L::Set(0.0);
+		size_t i = 0;
+		for (; i + L::Width <= n; i += L::Width) {
+			const auto v = L::Load(x + i);
+			squares = L::Fmadd(v, v, squares);
+			cosines = L::Add(cosines, Cos<L>(L::Mul(v, L::Set(Two_Pi))));
+		}
+
+		double square_sum = L::Reduce_Add(squares);
+		double cos_sum = L::Reduce_Add(cosines);
+		for (; i < n; i++) {
+			square_sum += x[i] * x[i];
+			cos_sum += std::cos(Two_Pi * x[i]);
+		}
+
+		const double dn = static_cast<double>(n);
+		return 20.0 + 2.71828182845904523536 - 20.0 * std::exp(-0.2 * std::sqrt(square_sum / dn)) - std::exp(cos_sum / dn);
+	}
+
+	template <typename L>
+	const TKernel_Table* Make_Kernel_Table() {
+		static const TKernel_Table table = {
+			&Sphere<L>, &Ellipsoid<L>, &Rosenbrock<L>, &Rastrigin<L>, &Griewank<L>, &Ackley<L>
+		};
+		return &table;
+	}
+}
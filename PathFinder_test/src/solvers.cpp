@@ -37,27 +37,39 @@
  */
 
 #include "solvers.h"
+#include "task_pool.h"
+#include "result_sink.h"
+#include "objective.h"
+#include "result_store.h"
+#include "isolated_run.h"
+#include "perf_counters.h"
+#include "memory_profile.h"
+#include "scratch_arena.h"
+#include "timing_setup.h"
 
 #include <scgms/rtl/scgmsLib.h>
 #include <scgms/rtl/SolverLib.h>
+#include <scgms/utils/string_utils.h>
 
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <set>
 #include <numeric>
+#include <cmath>
+#include <algorithm>
 #include <map>
 
 #include "scgms/iface/DistributedSolverIface.h"
 
+#ifndef _WIN32
+	#include <link.h>
+	#include <sys/stat.h>
+#endif
+
 namespace diagnostic {
 
-	// DISTRIBUTED SOLVER
-	namespace scgms_distributed_solver
-	{
-		constexpr GUID distributed_solver_generic = {0x7c9d3a41, 0x2f6b, 0x4e8d, {0xa1, 0x5c, 0x9e, 0x73, 0x4b, 0xd2, 0x11, 0xf8}};
-		// {7C9D3A41-2F6B-4E8D-A15C-9E734BD211F8}
-	}
+	// DISTRIBUTED SOLVER - see solvers.h
 
 
 	namespace mt_metade {	//mersenne twister initialized with linear random generator
@@ -135,18 +147,134 @@ namespace diagnostic {
 									  halton_metade::id, mt_metade::id, rnd_metade::id, ppr::spo_id,
 									  pathfinder::id_fast, pathfinder::id_spiral, pathfinder::id_landscape,
 									  //sequential_brute_force_scan::id, // disable for preliminary analysis (for full test, this should be enabled as a reference algorithm)
-									  pso::id, rumoropt::id
+									  pso::id, rumoropt::id,
+									  island_model::id
 									};
 
 		//some solvers fail on the problem size=> we need to check it to a avoid forcefull cancellation of a long computation
+
+	std::vector<GUID> default_island_solvers = { pathfinder::id_fast, pagmo::de1220_id, pagmo::sade_id, pagmo::cmaes_id, pagmo::pso_id, mt_metade::id };
+}
+
+//the island model wraps the registered solvers only; neither itself nor the distributed solver can be an island
+std::vector<GUID> Resolve_Island_Solvers(const TIsland_Setup &setup) {
+	const auto solversList = scgms::get_solver_descriptor_list();
+	const std::vector<GUID> &candidates = setup.solvers.empty() ? diagnostic::default_island_solvers : setup.solvers;
+
+	std::vector<GUID> solvers;
+	for (const GUID &id : candidates) {
+		if ((id == diagnostic::island_model::id) || (id == diagnostic::scgms_distributed_solver::distributed_solver_generic)) continue;
+		if (std::find_if(solversList.begin(), solversList.end(), [&id](const scgms::TSolver_Descriptor &desc) { return desc.id == id; }) != solversList.end())
+			solvers.push_back(id);
+	}
+
+	return solvers;
+}
+
+
+bool Is_Solver_Allowed(const scgms::TSolver_Descriptor &solver) {
+	if (diagnostic::debugging) {
+
+
+		if (diagnostic::allowed_solvers.find(solver.id) == diagnostic::allowed_solvers.end()) return false;
+
+		//if (wcsstr(solver.description, L"Pathfinder") == nullptr) return false;
+		//if (wcscmp(solver.description, L"Pathfinder")) return false;
+	}
+
+	return true;
+}
+
+bool Is_Solver_Faulty(const GUID &solver_id, const size_t problem_size) {
+	const auto fs = diagnostic::faulty_solvers.find(solver_id);
+	return (fs != diagnostic::faulty_solvers.end()) && (problem_size >= fs->second);
+}
+
+const std::vector<TRun_Metric> Run_Metrics = {
+	{ "optimum_fitness", &TRun_Record::optimum_fitness, &TSolver_Result::optimum_fitness },
+	{ "fitness", &TRun_Record::fitness, &TSolver_Result::fitness },
+	{ "fitness_error", &TRun_Record::fitness_error, &TSolver_Result::fitness_error },
+	{ "total_objective_calls", &TRun_Record::total_objective_calls, &TSolver_Result::total_objective_calls },
+	{ "least_objective_call", &TRun_Record::least_objective_call, &TSolver_Result::least_objective_call },
+	{ "least_objective_call_001", &TRun_Record::least_objective_call_001, &TSolver_Result::least_objective_call_001 },
+	{ "seconds", &TRun_Record::seconds, &TSolver_Result::seconds },
+	{ "generations", &TRun_Record::generations, &TSolver_Result::generations },
+	{ "evaluations_per_second", &TRun_Record::evaluations_per_second, &TSolver_Result::evaluations_per_second },
+	{ "objective_seconds", &TRun_Record::objective_seconds, &TSolver_Result::objective_seconds },
+	{ "overhead_seconds", &TRun_Record::overhead_seconds, &TSolver_Result::overhead_seconds },
+	{ "call_latency_p50_ns", &TRun_Record::call_latency_p50, &TSolver_Result::call_latency_p50 },
+	{ "call_latency_p99_ns", &TRun_Record::call_latency_p99, &TSolver_Result::call_latency_p99 },
+	{ "cache_hits", &TRun_Record::cache_hits, &TSolver_Result::cache_hits },
+	{ "cache_misses", &TRun_Record::cache_misses, &TSolver_Result::cache_misses },
+	{ "time_budget_used", &TRun_Record::time_budget_used, &TSolver_Result::time_budget_used },
+	{ "evaluation_budget_used", &TRun_Record::evaluation_budget_used, &TSolver_Result::evaluation_budget_used },
+	{ "cycles_per_evaluation", &TRun_Record::cycles_per_evaluation, &TSolver_Result::cycles_per_evaluation },
+	{ "instructions_per_evaluation", &TRun_Record::instructions_per_evaluation, &TSolver_Result::instructions_per_evaluation },
+	{ "instructions_per_cycle", &TRun_Record::instructions_per_cycle, &TSolver_Result::instructions_per_cycle },
+	{ "l1d_misses_per_evaluation", &TRun_Record::l1d_misses_per_evaluation, &TSolver_Result::l1d_misses_per_evaluation },
+	{ "llc_misses_per_evaluation", &TRun_Record::llc_misses_per_evaluation, &TSolver_Result::llc_misses_per_evaluation },
+	{ "branch_misses_per_evaluation", &TRun_Record::branch_misses_per_evaluation, &TSolver_Result::branch_misses_per_evaluation },
+	{ "context_switches", &TRun_Record::context_switches, &TSolver_Result::context_switches },
+	{ "allocations", &TRun_Record::allocations, &TSolver_Result::allocations },
+	{ "allocated_bytes", &TRun_Record::allocated_bytes, &TSolver_Result::allocated_bytes },
+	{ "peak_live_bytes", &TRun_Record::peak_live_bytes, &TSolver_Result::peak_live_bytes },
+	{ "allocations_per_evaluation", &TRun_Record::allocations_per_evaluation, &TSolver_Result::allocations_per_evaluation },
+	{ "peak_rss_delta_bytes", &TRun_Record::peak_rss_delta_bytes, &TSolver_Result::peak_rss_delta_bytes },
+	{ "cpu_seconds", &TRun_Record::cpu_seconds, &TSolver_Result::cpu_seconds },
+	{ "cpu_migrations", &TRun_Record::cpu_migrations, &TSolver_Result::cpu_migrations },
+	{ "disturbed", &TRun_Record::disturbed, &TSolver_Result::disturbed },
+};
+
+void Prepare_Solver_Result(TSolver_Result &result, const size_t problem_size, const bool streaming) {
+	result.optimum.resize(problem_size);
+	result.parameters.resize(problem_size);
+	if (!streaming) return;
+
+	for (auto &stats : result.optimum)
+		stats.Use_Streaming();
+	for (auto &stats : result.parameters)
+		stats.Use_Streaming();
+	result.abs_parameter_error.Use_Streaming();
+	result.abs_parameter_error_001.Use_Streaming();
 }
 
+void Append_Run_Record(TSolver_Result &result, const TRun_Record &record) {
+	if (record.fail_marker != NFail_Marker::None) {
+		if (record.fail_marker == NFail_Marker::Crashed) result.repetitions++;
+		result.fail_count++;
+		return;
+	}
+
+	result.repetitions++;
+	for (const auto &metric : Run_Metrics)
+		(result.*metric.stats).push_back(record.*metric.value);
+	result.stop_reasons[static_cast<size_t>(record.stop_reason)]++;
+
+	double parameter_error = 0.0;
+	for (size_t i = 0; i < record.parameters.size(); i++) {
+		result.optimum[i].push_back(record.optimum[i]);
+
+		result.parameters[i].push_back(record.parameters[i]);
+		result.abs_parameter_error.push_back(fabs(record.parameters[i] - record.optimum[i]));
+		parameter_error += fabs(record.parameters[i] - record.optimum[i]);
+	}
+	if (!record.parameters.empty()) result.run_parameter_error.push_back(parameter_error / static_cast<double>(record.parameters.size()));
+
+	for (size_t i = 0; i < record.parameters_001.size(); i++) {
+		result.abs_parameter_error_001.push_back(fabs(record.parameters_001[i] - record.optimum[i]));
+	}
+
+	if (!record.convergence.empty()) result.convergence.push_back(record.convergence);
+
+	if (record.failed) result.fail_count++;
+}
 
-void Run_Solver(const scgms::TSolver_Descriptor &desc, CCommon_Problem * working_problem, const size_t max_generations, const size_t population_size, TSolver_Result &result) {
+void Run_Solver(const scgms::TSolver_Descriptor &desc, CCommon_Problem * working_problem, const size_t max_generations, const size_t population_size, const TCampaign_Options &options, TRun_Record &record) {
 
 
-	CSolution lower_bound, upper_bound;
-	std::unique_ptr<CSolution> optimum = std::make_unique<CSolution>();	//when used for the semestral project, some people might have noticed that the optimum
+	TRun_Solutions &solutions = Thread_Run_Solutions();	//reused by the thread's runs, so that they do not allocate the temporaries again
+	CSolution &lower_bound = solutions.lower_bound, &upper_bound = solutions.upper_bound;
+	std::unique_ptr<CSolution> &optimum = solutions.optimum;	//when used for the semestral project, some people might have noticed that the optimum
 											//vector sits right after the upper_bound
 	double optimum_fitness;
 	working_problem->get_bounds(lower_bound, upper_bound);
@@ -154,72 +282,249 @@ void Run_Solver(const scgms::TSolver_Descriptor &desc, CCommon_Problem * working
 
 	bool failed = false;
 
-	CSolution local_parameters;
+	CSolution &local_parameters = solutions.parameters;
 	local_parameters.setConstant(std::numeric_limits<double>::quiet_NaN(), lower_bound.size());
 
 	//using TObjective_Function = BOOL(IfaceCalling*)(const void* data, const size_t count, const double* solution, double* const fitness);
 
 	// Distributed solver - solver's data
 	solver::TDistributedSolver_Data ds_data = {
-		"tproblem_udp", // Solver lib name
-		"tcp://localhost:5000", // Controller's address
-		8, // Expected worker count
+		options.distributed_library.c_str(), // Solver lib name
+		options.distributed_address.c_str(), // Controller's address
+		options.distributed_workers, // Expected worker count
 		working_problem, // Original content of the "data" field
 	};
 
+	//local solvers evaluate through our instrumented objective, the distributed one evaluates remotely and cannot be measured this way
+	TObjective_Context objective_context{ working_problem };
+	const bool distributed = desc.id == diagnostic::scgms_distributed_solver::distributed_solver_generic;
+
+	if (!distributed && (options.fitness_cache_entries > 0))	//per run, i.e., per problem instance
+		objective_context.cache = std::make_unique<CFitness_Cache>(lower_bound.size(), options.fitness_cache_entries);
+
 	// Distributed solver - replaced "working_problem" with "ds_data" here, removed pointer to objective
 	solver::TSolver_Setup solver_setup{ lower_bound.size(), 1,
 							lower_bound.data(), upper_bound.data(),
 							nullptr, 0,			//no hints
 							local_parameters.data(),
-							&ds_data, nullptr, nullptr,
+							distributed ? static_cast<const void*>(&ds_data) : static_cast<const void*>(&objective_context),
+							distributed ? nullptr : &Instrumented_Objective, nullptr,
 							max_generations, population_size, std::numeric_limits<double>::min(),
 	};
 
-	solver::TSolver_Progress solver_progress{ 0 };
+	Warm_Up_Problem(working_problem, lower_bound, upper_bound, options.timing.warm_up_evaluations);	//before the run's own objective calls are counted
+	if (!distributed) Reserve_Thread_Scratch(population_size > 0 ? population_size : 1);	//the solver's own threads size theirs on the first batch
 
+	solver::TSolver_Progress solver_progress{ 0 };
+	objective_context.evaluation_budget = options.budget.evaluations;
+
+	CRun_Watchdog watchdog{ solver_progress, options.budget, distributed ? nullptr : &objective_context, optimum_fitness };
+	objective_context.watchdog = &watchdog;
+	//an isolated run is alone in its process, even if the runs execute in parallel
+	const bool process_wide = (options.parallel_workers == 0) || options.isolated;
+	CAllocation_Scope allocation_scope{ process_wide };
+	if (options.memory_profile) allocation_scope.Start();
+	CPerf_Counters perf_counters;
+	if (options.perf_counters || options.timing.enabled) perf_counters.Start();	//after the watchdog has started, so that its thread does not count
+	CTiming_Probe timing_probe{ process_wide, options.timing.frequency_tolerance };
+	if (options.timing.enabled) timing_probe.Start();
+	//the run's time excludes the setup and the teardown of its probes
 	std::chrono::high_resolution_clock::time_point Solve_Start_Time = std::chrono::high_resolution_clock::now();
+	HRESULT solve_result = E_FAIL;
 	try {
-		if (solver::Solve_Generic(desc.id, solver_setup, solver_progress) != S_OK)
-			failed = true;
+		if (desc.id == diagnostic::island_model::id) {
+			TIsland_Setup island_setup = options.islands;
+			island_setup.solvers = Resolve_Island_Solvers(options.islands);
+			solve_result = Solve_Islands(solver_setup, solver_progress, island_setup);
+		}
+		else
+			solve_result = solver::Solve_Generic(desc.id, solver_setup, solver_progress);
 	}
 	catch (...) { failed = true; }
-
 	std::chrono::high_resolution_clock::time_point Solve_Stop_Time = std::chrono::high_resolution_clock::now();
 
+	const TTiming_Sample timing = options.timing.enabled ? timing_probe.Stop() : TTiming_Sample{};
+	const TPerf_Counts perf_counts = perf_counters.Stop();
+	const TAllocation_Counts allocation_counts = allocation_scope.Stop();
+	record.stop_reason = watchdog.Stop();
+	if ((solve_result != S_OK) && (record.stop_reason == NStop_Reason::Completed))	//a cancelled solver may report so, its solution is still valid
+		failed = true;
+
 	std::chrono::duration<double, std::milli> secs_duration = Solve_Stop_Time - Solve_Start_Time;
-	result.seconds.push_back(secs_duration.count()*0.001);
+	record.seconds = secs_duration.count()*0.001;
+	record.generations = static_cast<double>(solver_progress.current_progress);
+
+	if (!distributed) {
+		const double calls = static_cast<double>(objective_context.calls.load());
+		record.objective_seconds = static_cast<double>(objective_context.objective_nanoseconds.load()) * 1e-9;
+		//multi-threaded solvers may spend more objective time than the wall-clock one
+		record.overhead_seconds = record.seconds > record.objective_seconds ? record.seconds - record.objective_seconds : 0.0;
+		record.evaluations_per_second = record.seconds > 0.0 ? calls / record.seconds : std::numeric_limits<double>::quiet_NaN();
+		record.call_latency_p50 = objective_context.latency.Quantile(0.50);
+		record.call_latency_p99 = objective_context.latency.Quantile(0.99);
+		if (objective_context.cache) {
+			record.cache_hits = static_cast<double>(objective_context.cache->Hits());
+			record.cache_misses = static_cast<double>(objective_context.cache->Misses());
+		}
 
-	double total_calls, least_call, least_call_001;
-	CSolution params_001;
-	working_problem->Get_Objective_Calls(total_calls, least_call, least_call_001, params_001);
-	result.total_objective_calls.push_back(total_calls);
-	result.least_objective_call.push_back(least_call);
-	result.least_objective_call_001.push_back(least_call_001);
+		objective_context.trace.Get_Points(record.convergence);
+		for (auto &point : record.convergence)
+			point.fitness = fabs(point.fitness - optimum_fitness);
+	}
+
+	CSolution &params_001 = solutions.parameters_001;
+	working_problem->Get_Objective_Calls(record.total_objective_calls, record.least_objective_call, record.least_objective_call_001, params_001);
+
+	if (options.budget.seconds > 0.0) record.time_budget_used = record.seconds / options.budget.seconds;
+	if (options.budget.evaluations > 0) record.evaluation_budget_used = record.total_objective_calls / static_cast<double>(options.budget.evaluations);
+
+	//NaN counts, i.e., unavailable counters, propagate
+	const auto per_evaluation = [&perf_counts, &record](const NPerf_Counter counter) {
+		return record.total_objective_calls > 0.0 ? perf_counts[static_cast<size_t>(counter)] / record.total_objective_calls : std::numeric_limits<double>::quiet_NaN();
+	};
+	record.cycles_per_evaluation = per_evaluation(NPerf_Counter::Cycles);
+	record.instructions_per_evaluation = per_evaluation(NPerf_Counter::Instructions);
+	record.instructions_per_cycle = perf_counts[static_cast<size_t>(NPerf_Counter::Instructions)] / perf_counts[static_cast<size_t>(NPerf_Counter::Cycles)];
+	record.l1d_misses_per_evaluation = per_evaluation(NPerf_Counter::L1D_Read_Misses);
+	record.llc_misses_per_evaluation = per_evaluation(NPerf_Counter::LLC_Misses);
+	record.branch_misses_per_evaluation = per_evaluation(NPerf_Counter::Branch_Misses);
+	record.context_switches = perf_counts[static_cast<size_t>(NPerf_Counter::Context_Switches)];
+
+	record.allocations = allocation_counts.allocations;
+	record.allocated_bytes = allocation_counts.bytes;
+	record.peak_live_bytes = allocation_counts.peak_live_bytes;
+	record.allocations_per_evaluation = record.total_objective_calls > 0.0 ? allocation_counts.allocations / record.total_objective_calls : std::numeric_limits<double>::quiet_NaN();
+	record.peak_rss_delta_bytes = allocation_counts.peak_rss_delta_bytes;
+
+	if (options.timing.enabled) {
+		record.cpu_seconds = timing.cpu_seconds;
+		record.cpu_migrations = perf_counts[static_cast<size_t>(NPerf_Counter::CPU_Migrations)];
+		record.disturbed = (timing.migrated || timing.frequency_changed || (record.cpu_migrations > 0.0)) ? 1.0 : 0.0;
+	}
 
 	const double local_fitness = working_problem->Calculate_Fitness(local_parameters.data());
 	if (isnan(local_fitness)) failed = true;
 
-	result.optimum_fitness.push_back(optimum_fitness);
-	result.fitness.push_back(local_fitness);
-	result.fitness_error.push_back(fabs(local_fitness - optimum_fitness));
+	record.optimum_fitness = optimum_fitness;
+	record.fitness = local_fitness;
+	record.fitness_error = fabs(local_fitness - optimum_fitness);
+
+	record.optimum.assign(optimum->data(), optimum->data() + local_parameters.size());
+	record.parameters.assign(local_parameters.data(), local_parameters.data() + local_parameters.size());
+	record.parameters_001.assign(params_001.data(), params_001.data() + params_001.size());
 
-	for (size_t i = 0; i < local_parameters.size(); i++) {
-		result.optimum[i].push_back((*optimum)[i]);
+	record.failed = failed;
+}
 
-		result.parameters[i].push_back(local_parameters[i]);
-		result.abs_parameter_error.push_back(fabs(local_parameters[i] - (*optimum)[i]));
+namespace {
+	double Mean(const std::vector<double> &values) {
+		double sum = 0.0;
+		size_t count = 0;
+		for (const double value : values)
+			if (!std::isnan(value)) {
+				sum += value;
+				count++;
+			}
+		return count > 0 ? sum / static_cast<double>(count) : std::numeric_limits<double>::quiet_NaN();
 	}
 
-	for (size_t i = 0; i < params_001.size(); i++) {
-		result.abs_parameter_error_001.push_back(fabs(params_001[i] - (*optimum)[i]));
+	//adds the solvers, which need no more repetitions, see TAdaptive_Repetitions
+	void Settle_Solvers(const std::map<GUID, TSolver_Result> &results, const TAdaptive_Repetitions &adaptive, const size_t max_repetitions, std::set<GUID> &settled) {
+		const CStats TSolver_Result::* ranking_metrics[] = { &TSolver_Result::run_parameter_error, &TSolver_Result::fitness_error, &TSolver_Result::least_objective_call_001 };
+
+		auto is_precise = [&](const TSolver_Result &result) {
+			for (const auto metric : ranking_metrics) {
+				const CStats &values = result.*metric;
+				const double half_width = Mean_Confidence_Half_Width(values);
+				if (std::isnan(half_width)) {
+					if (values.size() < 2) return false;
+					continue;	//no value of the metric at all, e.g., 1% of the optimum has never been reached
+				}
+				if (half_width > adaptive.relative_ci_width * std::fabs(Mean(values))) return false;
+			}
+			return true;
+		};
+
+		//the leader by the mean abs_parameter_error of the runs, as in Report_Results
+		const TSolver_Result *leader = nullptr;
+		GUID leader_id = Invalid_GUID;	//the key of the results, which may differ from the leader's recorded solver_id
+		double leader_error = std::numeric_limits<double>::infinity();
+		for (const auto &result : results) {
+			const double error = Mean(result.second.run_parameter_error);
+			if (error < leader_error) {
+				leader_error = error;
+				leader = &result.second;
+				leader_id = result.first;
+			}
+		}
+
+		const size_t looks = max_repetitions > adaptive.min_repetitions ? max_repetitions - adaptive.min_repetitions + 1 : 1;
+		const double alpha = adaptive.alpha / static_cast<double>(looks);
+		const CStats leader_errors = leader ? leader->run_parameter_error : CStats{};
+
+		bool others_settled = true;
+		for (const auto &result : results) {
+			if ((&result.second == leader) || (settled.find(result.first) != settled.end())) continue;
+
+			if (result.second.repetitions == 0)
+				settled.insert(result.first);	//not run at all, e.g., not allowed or faulty
+			else if (result.second.repetitions >= adaptive.min_repetitions) {
+				const bool separated = leader && (Mann_Whitney_P_Value(result.second.run_parameter_error, leader_errors) < alpha);
+				if (separated || is_precise(result.second)) settled.insert(result.first);
+			}
+
+			if (settled.find(result.first) == settled.end()) others_settled = false;
+		}
+
+		//the leader needs no more runs, once it is precise, or there is nobody left to be ranked against
+		if (leader && (leader->repetitions >= adaptive.min_repetitions) && (others_settled || is_precise(*leader)))
+			settled.insert(leader_id);
 	}
+}
+
+namespace {
+	//the loaded shared objects, i.e., the solver libraries among them, by their path, size and modification time; empty, if they cannot be listed
+	std::string Loaded_Libraries_Description() {
+		std::vector<std::string> libraries;
+#ifndef _WIN32
+		dl_iterate_phdr([](struct dl_phdr_info *info, size_t, void *data) {
+			struct stat file_stat;
+			if (info->dlpi_name && info->dlpi_name[0] && (stat(info->dlpi_name, &file_stat) == 0)) {	//the executable itself has no name
+				const std::string description = std::string{ info->dlpi_name } + ":" + std::to_string(file_stat.st_size) + ":" + std::to_string(file_stat.st_mtime);
+				static_cast<std::vector<std::string>*>(data)->push_back(description);
+			}
+			return 0;
+		}, &libraries);
+#endif
+		std::sort(libraries.begin(), libraries.end());	//independent of the load order
+
+		std::string description;
+		for (const auto &library : libraries)
+			description += library + ";";
+		return description;
+	}
+}
+
+//identifies the solvers' build by the loaded libraries and the descriptors, options.build_id adds what cannot be told this way;
+//0, i.e., unknown, if the libraries cannot be listed and no build_id is given, so that no run is replayed across the campaigns
+uint64_t Solvers_Build_Hash(const TCampaign_Options &options) {
+	const auto solvers = scgms::get_solver_descriptor_list();	//loads the solver libraries, if they are not loaded yet
+	const std::string libraries = Loaded_Libraries_Description();
+	if (libraries.empty() && options.build_id.empty()) return 0;
 
-	if (failed) result.fail_count++;
+	std::string description = libraries;
+	description += options.build_id;
 
+	for (const auto &solver : solvers) {
+		description += ";";
+		description += Narrow_WString(GUID_To_WString(solver.id));
+		description += Narrow_WString(solver.description);
+	}
+
+	return Build_Hash(description);
 }
 
-std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *problem, bool randomize_optimum) {
+std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *problem, const TProblem_Info &problem_info, const TCampaign_Options &options) {
 
 	std::vector<TSolver_Result> results;
 
@@ -228,7 +533,7 @@ std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *pro
 	//check, whether the problem can be actually solved
 	if (!problem->Can_Be_Solved()) return results; //likely, the problem cannot be solved for this particular problem size, thus causing some algorithms to fail or run forever, such as Pagmo::ABC
 
-	size_t Max_Generations = 100'000;
+	size_t Max_Generations = options.max_generations;
 	std::vector<size_t> population_size = { 7, 15, 25, 40, 60, 100 };
 
 	if (diagnostic::debugging) {
@@ -236,64 +541,150 @@ std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *pro
 		population_size = { 100 };
 	}
 
-	//#################################################################################
-	// DISTRIBUTED SOLVER - TEMPORARILY DISABLE ALL OTHER SOLVERS
-	//#################################################################################
-	const auto solversList = scgms::get_solver_descriptor_list();
-	int distSolverIndex = 0;
-	for (int i = 0; i < solversList.size(); ++i)
-	{
-		const auto& solver = solversList[i];
-		std::wstring s = solver.description;
-		if (s.find(L"distributed") != std::wstring::npos)
-		{
-			distSolverIndex = i;
-			break;
+	if (!options.population_sizes.empty()) population_size = options.population_sizes;
+
+	auto solversList = scgms::get_solver_descriptor_list();
+	solversList.push_back(Island_Model_Descriptor());	//the meta-solver runs here, not in the solver libraries
+	std::vector<scgms::TSolver_Descriptor> solvers;
+	const bool explicit_solvers = !options.solvers.empty();	//the campaign's selection overrides diagnostic::allowed_solvers
+	if (explicit_solvers) {
+		for (const auto &selected : options.solvers) {
+			bool ok = false;
+			const GUID selected_id = WString_To_GUID(selected, ok);
+			const auto solver = std::find_if(solversList.begin(), solversList.end(), [&](const scgms::TSolver_Descriptor &desc) {
+				return ok ? desc.id == selected_id : selected == desc.description;
+			});
+
+			if (solver != solversList.end()) solvers.push_back(*solver);
+			else std::wcout << L"Cannot find the solver " << selected << L", ignoring it..." << std::endl;
 		}
 	}
-	const auto solvers = {solversList[distSolverIndex]};
-	//#################################################################################
+	else {
+		//#################################################################################
+		// DISTRIBUTED SOLVER - TEMPORARILY DISABLE ALL OTHER SOLVERS
+		//#################################################################################
+		int distSolverIndex = 0;
+		for (int i = 0; i < solversList.size(); ++i)
+		{
+			const auto& solver = solversList[i];
+			std::wstring s = solver.description;
+			if (s.find(L"distributed") != std::wstring::npos)
+			{
+				distSolverIndex = i;
+				break;
+			}
+		}
+		solvers = {solversList[distSolverIndex]};
+		//#################################################################################
 
-	//const auto solvers = scgms::get_solver_descriptor_list();
+		//solvers = scgms::get_solver_descriptor_list();
+	}
 	auto working_problem = problem->Clone();
+	const uint64_t build_hash = Solvers_Build_Hash(options);
+	const bool adaptive = options.adaptive.enabled && (options.shard_count == 1);
 
 
 	for (const size_t current_population_size : population_size) {
 
 		std::map<GUID, TSolver_Result> working_results;
-		auto run_solver = [&working_problem, Max_Generations, current_population_size, randomize_optimum](const scgms::TSolver_Descriptor& solver, TSolver_Result &result) {
-			if (diagnostic::debugging) {
-
-
-				if (diagnostic::allowed_solvers.find(solver.id) == diagnostic::allowed_solvers.end()) return;
-
-				//if (wcsstr(solver.description, L"Pathfinder") == nullptr) return;
-				//if (wcscmp(solver.description, L"Pathfinder")) return;
+		std::mutex console_lock;	//the parallel workers report their progress concurrently
+		CIsolation_Server isolation_server;	//forks the isolated runs of the parallel mode, see CIsolation_Server
+		//cell_index - of the parallel cells, whose isolated runs fork from isolation_server, npos in the sequential mode
+		auto run_solver = [&console_lock, &options, &isolation_server, Max_Generations, current_population_size](const scgms::TSolver_Descriptor& solver, CCommon_Problem* solver_problem, TRun_Record &record, const size_t cell_index) {
+			solver_problem->reset_counters();
+			{
+				std::lock_guard<std::mutex> lock{ console_lock };
+				std::wcout << L"Running solver: " << solver.description << std::endl;
 			}
+			bool completed = true;
+			if (options.isolated) {
+				std::string failure;
+				if (cell_index != std::numeric_limits<size_t>::max())
+					completed = isolation_server.Run(cell_index, record, failure);
+				else
+					completed = Run_Isolated([&](TRun_Record &isolated_record) {
+						Run_Solver(solver, solver_problem, Max_Generations, current_population_size, options, isolated_record);
+					}, record, options.isolation, failure);
+
+				if (!completed) {
+					std::lock_guard<std::mutex> lock{ console_lock };
+					std::wcout << L"Isolated solver " << solver.description << L" has failed: " << Widen_String(failure) << std::endl;
+				}
+			}
+			else
+				Run_Solver(solver, solver_problem, Max_Generations, current_population_size, options, record);
 
-
-			working_problem->reset_counters();
-			std::wcout << L"Running solver: " << solver.description << std::endl;
-			Run_Solver(solver, working_problem.get(), Max_Generations, current_population_size, result);
+			if (completed && options.sink) options.sink->Append_Run(record);
+			return completed;	//false, if the isolated run has crashed, i.e., there is no record
 		};
 
-
-		//initialize the results
-		for (const auto& solver : solvers) {
-
+		auto create_result = [&problem, &options, current_population_size](const scgms::TSolver_Descriptor& solver) {
 			TSolver_Result result;
-			result.optimum.resize(problem->Problem_Size());
-			result.parameters.resize(problem->Problem_Size());
+			Prepare_Solver_Result(result, problem->Problem_Size(), options.streaming_stats);
 			result.name = solver.description;
 			if (current_population_size > 0) {
 				result.name += L"_";
 				result.name += std::to_wstring(current_population_size);
 			}
 			result.fail_count = 0;
+			result.solver_id = solver.id;
+			result.population_size = current_population_size;
+
+			return result;
+		};
+
+		auto create_record = [&problem_info, &options, Max_Generations, current_population_size, build_hash](const scgms::TSolver_Descriptor& solver, const TSolver_Result &result, const size_t repetition, const uint64_t shift_fingerprint) {
+			TRun_Record record;
+			record.solver_id = result.solver_id;
+			record.solver_name = result.name;
+			record.problem_name = problem_info.name;
+			record.problem_ordinal = problem_info.ordinal;
+			record.problem_size = problem_info.size;
+			record.population_size = current_population_size;
+			record.repetition = repetition;
+			record.shift_fingerprint = shift_fingerprint;
+			record.build_hash = build_hash;
+			record.max_generations = Max_Generations;
+			record.budget = options.budget;
+			if (solver.id == diagnostic::scgms_distributed_solver::distributed_solver_generic) record.distributed_workers = options.distributed_workers;
+			record.randomized = options.randomize_optimum;
+
+			return record;
+		};
 
-			working_results[solver.id] = result;
+		//a deterministic solver runs once per problem instance, its other repetitions replay that run
+		//the failures without a run go to the store only, so that a merge of the shards counts them as well
+		auto store_fail_marker = [&options](TRun_Record record, const NFail_Marker marker) {
+			if (!options.store) return;
+			record.failed = true;
+			record.fail_marker = marker;
+			options.store->Append_Run(record);
+		};
+
+		auto runs_once = [](const scgms::TSolver_Descriptor& solver) {
+			return diagnostic::run_deterministic_solver_once && (diagnostic::deterministic_solvers.find(solver.id) != diagnostic::deterministic_solvers.end());
+		};
+		std::map<TDeterministic_Key, TRun_Record> deterministic_runs;	//sequential mode
+		std::map<TDeterministic_Key, size_t> deterministic_cells;		//parallel mode, index of the cell, which runs the key
+
+
+		//initialize the results
+		for (const auto& solver : solvers) {
+			working_results[solver.id] = create_result(solver);
 		}
 
+		//in the parallel mode, each (repetition, solver) cell gets its own run record and a snapshot of the repetition's problem instance
+		//the records are appended in the very same order as the sequential run would produce them
+		struct TParallel_Cell {
+			scgms::TSolver_Descriptor solver;
+			TRun_Record record;
+			bool completed = false;	//already in the result store, or replayed from it
+			bool crashed = false;
+			size_t replay_of = std::numeric_limits<size_t>::max();	//index of the cell with the same deterministic run
+		};
+		std::vector<TParallel_Cell> parallel_cells;
+		std::vector<decltype(problem->Clone())> repetition_problems;
+		const bool parallel = options.parallel_workers > 0;
 
 
 		std::wcout << L"Executing repetition... " << std::endl;
@@ -302,231 +693,314 @@ std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *pro
 			std::wcout << j << "; ";
 		std::wcout << std::endl;
 
-		for (size_t repetition = 0; repetition < repetitions; repetition++) {
-			if (randomize_optimum) working_problem->randomize_shift();	//we need to ensure that in each iteration each solver has exactly the same problem
-
-			//print optimum parameters:
-			std::wcout << repetition << L"; ";
-			CSolution optimum_params;
-			double optimum_fitness;
-			working_problem->get_optimum(optimum_params, optimum_fitness);
-			for (size_t j = 0; j < working_problem->Problem_Size(); j++)
-				std::wcout << optimum_params[j] << "; ";
-			std::wcout << std::endl << std::flush;
-
-
-			for (const auto& solver : solvers) {
-				TSolver_Result &result = working_results[solver.id];
-
-				bool faulty = solver.specialized;	//skip specilazed solvers as well
-				//check if it is faulty solver
-				if (!faulty) {
-					const auto fs = diagnostic::faulty_solvers.find(solver.id);
-					if (fs != diagnostic::faulty_solvers.end()) {
-						if (problem->Problem_Size() >= fs->second) {
-							result.fail_count++;
-							faulty = true;
-							break;
+		//the adaptive mode runs the repetitions in rounds and settles the solvers after each round, the fixed mode runs them all in a single round
+		std::set<GUID> settled;
+		for (size_t round_begin = 0; round_begin < repetitions; ) {
+			size_t round_end = repetitions;
+			if (adaptive) {
+				const size_t active = solvers.size() - settled.size();
+				const size_t round_size = parallel ? (options.parallel_workers + active - 1) / active : 1;	//enough cells to keep the pool busy
+				if (round_begin + round_size < repetitions) round_end = round_begin + round_size;
+			}
+
+			for (size_t repetition = round_begin; repetition < round_end; repetition++) {
+				if (options.randomize_optimum) working_problem->randomize_shift();	//we need to ensure that in each iteration each solver has exactly the same problem
+
+				//print optimum parameters:
+				std::wcout << repetition << L"; ";
+				CSolution optimum_params;
+				double optimum_fitness;
+				working_problem->get_optimum(optimum_params, optimum_fitness);
+				for (size_t j = 0; j < working_problem->Problem_Size(); j++)
+					std::wcout << optimum_params[j] << "; ";
+				std::wcout << std::endl << std::flush;
+				const uint64_t shift_fingerprint = Shift_Fingerprint(optimum_params, optimum_fitness);
+
+				if (parallel) repetition_problems.push_back(working_problem->Clone());
+
+				for (const auto& solver : solvers) {
+					TSolver_Result &result = working_results[solver.id];
+					if (settled.find(solver.id) != settled.end()) continue;
+
+					bool faulty = solver.specialized;	//skip specilazed solvers as well
+					//check if it is faulty solver
+					if (!faulty && Is_Solver_Faulty(solver.id, problem->Problem_Size())) {
+						store_fail_marker(create_record(solver, result, repetition, shift_fingerprint), NFail_Marker::Faulty);
+						result.fail_count++;
+						continue;	//the later solvers still run
+					}
+
+					if (!faulty && (explicit_solvers || Is_Solver_Allowed(solver))) {
+						TRun_Record record = create_record(solver, result, repetition, shift_fingerprint);
+						const bool once = runs_once(solver);
+
+						//all the repetitions of a deterministic instance go to the same shard, so that they can be replayed
+						if ((options.shard_count > 1) && (Cell_Hash(record, once) % options.shard_count != options.shard_index)) continue;
+
+						bool completed = options.store && options.store->Find(record);
+						if (completed) std::wcout << L"Reusing stored result of solver: " << solver.description << std::endl;
+
+						const auto key = Deterministic_Key(record);
+						size_t replay_of = std::numeric_limits<size_t>::max();
+						if (!completed && once) {
+							const auto run = deterministic_runs.find(key);
+							const auto cell = deterministic_cells.find(key);
+							if (run != deterministic_runs.end()) {
+								Replay_Run_Record(run->second, record);
+								completed = true;
+							}
+							else if (cell != deterministic_cells.end())
+								replay_of = cell->second;	//the cell has not run yet
+							else
+								completed = options.store && options.store->Find_Deterministic(record);
+
+							if (completed) {
+								std::wcout << L"Replaying deterministic result of solver: " << solver.description << std::endl;
+								if (options.sink) options.sink->Append_Run(record);
+							}
 						}
 
+						if (parallel) {
+							if (once && !completed && (replay_of == std::numeric_limits<size_t>::max())) deterministic_cells[key] = parallel_cells.size();
+							parallel_cells.push_back({ solver, std::move(record), completed, false, replay_of });
+						}
+						else {
+							if (!completed && !run_solver(solver, working_problem.get(), record, std::numeric_limits<size_t>::max())) {
+								store_fail_marker(record, NFail_Marker::Crashed);
+								result.fail_count++;
+								result.repetitions++;
+							}
+							else {
+								if (once && (record.stop_reason == NStop_Reason::Completed) && (record.fail_marker == NFail_Marker::None)) deterministic_runs.emplace(key, record);
+								Append_Run_Record(result, record);
+							}
+						}
 					}
 				}
-
-				if (!faulty) run_solver(solver, result);
 			}
-		}
-		std::wcout << std::endl;
-
-		//put the results to the overall results
-		for (auto& result : working_results)
-			results.push_back(std::move(result.second));
-	}
-
-
-
-	return results;
-}
-
-void Evaluate_Solvers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, bool randomize_optimum) {
-
-	const size_t problem_size = problem->Problem_Size();
-
-	//write prolog
-	{
-		double fitness;
-		CSolution optimum, ub;
-		problem->get_bounds(optimum, ub);
-		problem->get_optimum(optimum, fitness);
-		std::cout << "--=== Evaluating solvers on " << problem->Get_Name() << " with problem size = " << problem_size << "... ===--" << std::endl;
-		std::cout << "Problem ordinal number: " << problem_ordinal_number << std::endl;
-		std::cout.precision(3);
-		std::cout << "upper_bound[0]=" << ub[0] << ", optimum_analytical_parameter[0]=" << optimum[0] << ", optimum_fitness=" << fitness << std::endl << std::endl;
-	}
-
-	//1. run and collect results
-	std::vector<TSolver_Result> results = Run_Solvers(repetitions, problem, randomize_optimum);
-
-	if (!results.empty()) {
-		//print the fitness and its optimium as avg +- stdev
-		CStats global_optimum_fitness;
-		std::vector<CStats> global_optimum{ problem_size };
 
+			if (parallel) {
+				//forked while the process is still single-threaded, the runs then fork from it, not from the pool's threads
+				if (options.isolated && !isolation_server.Start([&](const size_t i, TRun_Record &record) {
+						const auto &cell = parallel_cells[i];
+						auto instance = repetition_problems[cell.record.repetition]->Clone();
+						record = cell.record;
+						Run_Solver(cell.solver, instance.get(), Max_Generations, current_population_size, options, record);
+					}, options.isolation))
+					std::wcout << L"Cannot start the isolation server, the isolated runs will fail." << std::endl;
+
+				CWork_Stealing_Pool pool{ options.parallel_workers };
+
+				struct TWorker_Problem {
+					size_t repetition = std::numeric_limits<size_t>::max();
+					decltype(problem->Clone()) instance;
+				};
+				const size_t serial_worker = pool.Worker_Count();	//the calling thread, which runs the serial cells after the pool
+				std::vector<TWorker_Problem> worker_problems(serial_worker + 1);
+
+				auto cell_task = [&](const size_t i) {
+					return [&, i](const size_t worker_index) {
+						auto &cell = parallel_cells[i];
+						auto &worker = worker_problems[worker_index];
+						if (!options.timing.cpus.empty() && (worker_index != serial_worker))	//each worker on its own core of the set
+							Pin_Current_Thread({ options.timing.cpus[worker_index % options.timing.cpus.size()] }, options.timing.numa_local);
+						try {
+							if (worker.repetition != cell.record.repetition) {	//each worker solves on its own clone of the repetition's problem instance
+								worker.instance = repetition_problems[cell.record.repetition]->Clone();
+								worker.repetition = cell.record.repetition;
+							}
+
+							if (!run_solver(cell.solver, worker.instance.get(), cell.record, i)) cell.crashed = true;
+						}
+						catch (...) {
+							cell.crashed = true;
+							worker.repetition = std::numeric_limits<size_t>::max();	//do not trust the clone anymore
+						}
+					};
+				};
+
+				//the distributed solver's runs share the controller's endpoint and the workers => they run one by one, after the pool
+				auto execute = [&](const std::vector<size_t> &cells) {
+					std::vector<CWork_Stealing_Pool::TTask> tasks;
+					std::vector<size_t> serial_cells;
+					for (const size_t i : cells) {
+						if (parallel_cells[i].solver.id == diagnostic::scgms_distributed_solver::distributed_solver_generic) serial_cells.push_back(i);
+						else tasks.push_back(cell_task(i));
+					}
+					pool.Execute(tasks);
 
+					for (const size_t i : serial_cells)
+						cell_task(i)(serial_worker);
+				};
 
-		//2. evaluate the results
-		for (auto &stats : results) {
-			for (auto &param : stats.parameters)
-				param.Calculate_Stats();
+				std::vector<size_t> cells;
+				for (size_t i = 0; i < parallel_cells.size(); i++) {
+					if (parallel_cells[i].completed || (parallel_cells[i].replay_of != std::numeric_limits<size_t>::max())) continue;
+					cells.push_back(i);
+				}
+				execute(cells);
 
-			stats.abs_parameter_error.Calculate_Stats();
-			stats.fitness.Calculate_Stats();
+				//a deterministic run cut short by a budget is not the solver's result, thus the cells, which were to replay it, run on their own
+				cells.clear();
+				for (size_t i = 0; i < parallel_cells.size(); i++) {
+					auto &cell = parallel_cells[i];
+					if ((cell.replay_of == std::numeric_limits<size_t>::max()) || parallel_cells[cell.replay_of].crashed) continue;
+					if (parallel_cells[cell.replay_of].record.stop_reason == NStop_Reason::Completed) continue;
 
-			stats.fitness_error.Calculate_Stats();
-			stats.abs_parameter_error.Calculate_Stats();
-			stats.abs_parameter_error_001.Calculate_Stats();
+					cell.replay_of = std::numeric_limits<size_t>::max();
+					cells.push_back(i);
+				}
+				execute(cells);
 
-			stats.total_objective_calls.Calculate_Stats();
-			stats.least_objective_call.Calculate_Stats();
-			stats.least_objective_call_001.Calculate_Stats();
+				for (auto &cell : parallel_cells) {
+					if (cell.replay_of == std::numeric_limits<size_t>::max()) continue;
 
-			stats.seconds.Calculate_Stats();
+					const auto &source = parallel_cells[cell.replay_of];
+					cell.crashed = source.crashed;
+					if (!cell.crashed) {
+						std::wcout << L"Replaying deterministic result of solver: " << cell.solver.description << std::endl;
+						Replay_Run_Record(source.record, cell.record);
+						if (options.sink) options.sink->Append_Run(cell.record);
+					}
+				}
 
-			if (randomize_optimum) {
-				global_optimum_fitness.insert(global_optimum_fitness.end(), stats.optimum_fitness.begin(), stats.optimum_fitness.end());
-				for (size_t i = 0; i < problem_size; i++) {
-					global_optimum[i].insert(global_optimum[i].begin(), stats.optimum[i].begin(), stats.optimum[i].end());
+				for (const auto &cell : parallel_cells) {
+					TSolver_Result &result = working_results[cell.solver.id];
+					if (!cell.crashed) {
+						if (runs_once(cell.solver) && (cell.record.stop_reason == NStop_Reason::Completed) && (cell.record.fail_marker == NFail_Marker::None))
+							deterministic_runs.emplace(Deterministic_Key(cell.record), cell.record);	//replayed by the later rounds
+						Append_Run_Record(result, cell.record);
+					}
+					else {
+						store_fail_marker(cell.record, NFail_Marker::Crashed);
+						result.fail_count++;
+						result.repetitions++;
+					}
 				}
+
+				isolation_server.Stop();
+				parallel_cells.clear();
+				deterministic_cells.clear();
 			}
+			if (adaptive) Settle_Solvers(working_results, options.adaptive, repetitions, settled);
+			if (settled.size() == solvers.size()) break;
+			round_begin = round_end;
 		}
+		std::wcout << std::endl;
 
-		if (randomize_optimum) {
-			global_optimum_fitness.Calculate_Stats();
-			for (auto& opt : global_optimum)
-				opt.Calculate_Stats();
-			std::cout << "randomized optimum_fitness=" << global_optimum_fitness.Get_Stats().avg << " +/- " << global_optimum_fitness.Get_Stats().stddev << std::endl;
-			std::cout << std::endl;
+		//put the results to the overall results
+		for (auto& result : working_results) {
+			if ((options.shard_count > 1) && result.second.seconds.empty() && (result.second.fail_count == 0)) continue;	//no cell of this shard
+			results.push_back(std::move(result.second));
 		}
+	}
 
 
 
-		//find the best algorithm by fitness error, avg param error and then by time
-		std::sort(results.begin(), results.end(), [](const TSolver_Result &a, TSolver_Result &b) {
-			int fails = a.fail_count - b.fail_count;
-			if (fails != 0) return fails < 0; // a.fail_count <= b.fail_count;
+	return results;
+}
 
-			double diff = a.abs_parameter_error.Get_Stats().avg - b.abs_parameter_error.Get_Stats().avg;
-			if (diff != 0.0) return diff < 0.0; //a.abs_parameter_error.Get_Stats().avg < b.abs_parameter_error.Get_Stats().avg;
+void Report_Results(const TProblem_Info &problem_info, std::vector<TSolver_Result> &results, IResult_Sink &sink) {
+	const size_t problem_size = problem_info.size;
 
-			diff = a.fitness_error.Get_Stats().avg - b.fitness_error.Get_Stats().avg;
-			if (diff != 0.0) return diff < 0.0; //a.fitness_error.Get_Stats().avg < b.fitness_error.Get_Stats().avg;
+	//print the fitness and its optimium as avg +- stdev
+	CStats global_optimum_fitness;
+	std::vector<CSample_Stats> global_optimum{ problem_size };
 
-			diff = a.abs_parameter_error_001.Get_Stats().avg - b.abs_parameter_error_001.Get_Stats().avg;
-			if (diff != 0.0) return diff < 0.0;
 
-			diff = a.least_objective_call_001.Get_Stats().avg - b.least_objective_call_001.Get_Stats().avg;
-			if (diff != 0.0) return diff < 0.0;
 
-			return wcscmp(a.name.c_str(), b.name.c_str()) < 0;
+	//2. evaluate the results
+	for (auto &stats : results) {
+		for (auto &param : stats.parameters)
+			param.Calculate_Stats();
 
-			//return a.seconds.Get_Stats().avg < b.seconds.Get_Stats().avg; - comparing the seconds is no longer relevant due to the massively parallel execution
-		});
+		stats.abs_parameter_error.Calculate_Stats();
+		stats.abs_parameter_error_001.Calculate_Stats();
 
+		for (const auto &metric : Run_Metrics)
+			(stats.*metric.stats).Calculate_Stats();
 
-		std::vector<CStats> parameters;
-		CStats fitness;
+		if (problem_info.randomized) {
+			global_optimum_fitness.insert(global_optimum_fitness.end(), stats.optimum_fitness.begin(), stats.optimum_fitness.end());
+			for (size_t i = 0; i < problem_size; i++) {
+				global_optimum[i].Merge(stats.optimum[i]);
+			}
+		}
+	}
 
-		CStats fitness_error;
-		CStats abs_parameter_error;
+	if (problem_info.randomized) {
+		global_optimum_fitness.Calculate_Stats();
+		for (auto& opt : global_optimum)
+			opt.Calculate_Stats();
+		std::cout << "randomized optimum_fitness=" << global_optimum_fitness.Get_Stats().avg << " +/- " << global_optimum_fitness.Get_Stats().stddev << std::endl;
+		std::cout << std::endl;
+	}
 
-		CStats total_objective_calls;
-		CStats least_objective_call;
-		CStats least_objective_call_001;
 
-		CStats seconds;
 
+	//find the best algorithm by fitness error, avg param error and then by time
+	std::sort(results.begin(), results.end(), [](const TSolver_Result &a, TSolver_Result &b) {
+		int fails = a.fail_count - b.fail_count;
+		if (fails != 0) return fails < 0; // a.fail_count <= b.fail_count;
 
-		//3. print the results
-		std::cout << std::endl;
-		std::string title_line = "general;;;;;;;;";
-		std::string header_line = "solver; fails; param_err; fitness_err; least_calls; lc_001; param_err001; ";
+		double diff = a.abs_parameter_error.Get_Stats().avg - b.abs_parameter_error.Get_Stats().avg;
+		if (diff != 0.0) return diff < 0.0; //a.abs_parameter_error.Get_Stats().avg < b.abs_parameter_error.Get_Stats().avg;
 
-		auto add_params = [&title_line, &header_line, problem_size](const char* title) {
-			title_line += title;
-			title_line += ";;;;;;;;;";
-			header_line += "; fitness; fitness_err; param_err; time; total calls; least calls; lc_001; pe_001; ";
-			for (size_t i = 0; i < problem_size; i++) {
-				title_line += "; ";
-				header_line += std::to_string(i);
-				header_line += "; ";
-			}
-		};
+		diff = a.fitness_error.Get_Stats().avg - b.fitness_error.Get_Stats().avg;
+		if (diff != 0.0) return diff < 0.0; //a.fitness_error.Get_Stats().avg < b.fitness_error.Get_Stats().avg;
 
-		add_params("Average");
-		add_params("Standard Deviation");
-		add_params("Minimum");
-		add_params("Q25");
-		add_params("Median");
-		add_params("Q75");
-		add_params("Maximum");
+		diff = a.abs_parameter_error_001.Get_Stats().avg - b.abs_parameter_error_001.Get_Stats().avg;
+		if (diff != 0.0) return diff < 0.0;
 
-		std::cout << title_line << std::endl;
-		std::cout << header_line << std::endl;
+		diff = a.least_objective_call_001.Get_Stats().avg - b.least_objective_call_001.Get_Stats().avg;
+		if (diff != 0.0) return diff < 0.0;
 
+		return wcscmp(a.name.c_str(), b.name.c_str()) < 0;
 
-		auto write_marker = [problem_size](auto getter, const TSolver_Result &result) {
-			std::cout.precision(std::numeric_limits< double >::max_digits10);
-			std::cout << std::scientific;
-			std::cout << getter(result.fitness) << "; ";
-			std::cout << getter(result.fitness_error) << "; ";
-			std::cout << getter(result.abs_parameter_error) << "; ";
+		//return a.seconds.Get_Stats().avg < b.seconds.Get_Stats().avg; - comparing the seconds is no longer relevant due to the massively parallel execution
+	});
 
-			std::cout.precision(3);
-			std::cout << getter(result.seconds) << "; ";
 
-			std::cout.precision(std::numeric_limits< double >::max_digits10);
-			std::cout << std::scientific;
-			std::cout << getter(result.total_objective_calls) << "; ";
-			std::cout << getter(result.least_objective_call) << "; ";
-			std::cout << getter(result.least_objective_call_001) << "; ";
-			std::cout << getter(result.abs_parameter_error_001);
+	//3. report the results
+	sink.End_Problem(problem_info, results);
+}
 
+std::vector<TSolver_Result> Evaluate_Solvers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, const TCampaign_Options &options) {
 
-			for (size_t i = 0; i < problem_size; i++)
-				std::cout << "; " << getter(result.parameters[i]);
+	const size_t problem_size = problem->Problem_Size();
 
-			std::cout << ";;";
-		};
+	TProblem_Info problem_info;
+	problem_info.name = problem->Get_Name();
+	problem_info.ordinal = problem_ordinal_number;
+	problem_info.size = problem_size;
+	problem_info.randomized = options.randomize_optimum;
 
-		auto write_avg_stddev = [](auto getter) {
-			const auto &stats = getter().Get_Stats();
-			std::cout << stats.avg << " � " << stats.stddev << "; ";
-		};
+	CCSV_Sink default_sink;
+	IResult_Sink &sink = options.sink ? *options.sink : default_sink;
 
+	//write prolog
+	{
+		double fitness;
+		CSolution optimum, ub;
+		problem->get_bounds(optimum, ub);
+		problem->get_optimum(optimum, fitness);
+		std::cout << "--=== Evaluating solvers on " << problem->Get_Name() << " with problem size = " << problem_size << "... ===--" << std::endl;
+		std::cout << "Problem ordinal number: " << problem_ordinal_number << std::endl;
+		std::cout.precision(3);
+		std::cout << "upper_bound[0]=" << ub[0] << ", optimum_analytical_parameter[0]=" << optimum[0] << ", optimum_fitness=" << fitness << std::endl << std::endl;
+	}
 
-		for (size_t i = 0; i < results.size(); i++) {
-			const auto &result = results[i];
-			std::wcout << result.name << "; " << result.fail_count << "; ";
-			std::cout.precision(3);
-			std::cout << std::scientific;
-
-			write_avg_stddev([&result]() {return result.abs_parameter_error; });
-			write_avg_stddev([&result]() {return result.fitness_error; });
-			write_avg_stddev([&result]() {return result.least_objective_call; });
-			write_avg_stddev([&result]() {return result.least_objective_call_001; });
-			write_avg_stddev([&result]() {return result.abs_parameter_error_001; });
-
-			std::cout << ";";
-			write_marker([](const CStats &stats) {return stats.Get_Stats().avg; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().stddev; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().min; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().q25; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().med; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().q75; }, result);
-			write_marker([](const CStats &stats) {return stats.Get_Stats().max; }, result);
-			std::cout << std::endl;
-		}
+	//1. run and collect results
+	sink.Begin_Problem(problem_info);
+	std::vector<TSolver_Result> results = Run_Solvers(repetitions, problem, problem_info, options);
+
+	if (!results.empty()) {
+		//2. evaluate and 3. report the results
+		Report_Results(problem_info, results, sink);
 	} else
 	  std::cout << "This problem cannot be solved with the chosen problem size.";
 
 	std::cout << std::endl << "--=== " << problem->Get_Name() << " evaluation completed. ===--" << std::endl << std::endl;
+
+	return results;
 }
\ No newline at end of file
@@ -44,31 +44,208 @@
 #include "TProblemData.h"
 
 #include "stats.h"
+#include "objective.h"
+#include "run_budget.h"
+#include "isolated_run.h"
+#include "timing_setup.h"
+#include "island_model.h"
 
 
+#include <array>
 #include <mutex>
+#include <memory>
+
+namespace diagnostic {
+	// DISTRIBUTED SOLVER
+	namespace scgms_distributed_solver
+	{
+		constexpr GUID distributed_solver_generic = {0x7c9d3a41, 0x2f6b, 0x4e8d, {0xa1, 0x5c, 0x9e, 0x73, 0x4b, 0xd2, 0x11, 0xf8}};
+		// {7C9D3A41-2F6B-4E8D-A15C-9E734BD211F8}
+	}
+}
 
 struct TSolver_Result {	
 
 	int fail_count = 0;	//int due to easier comparison
+	size_t repetitions = 0;	//runs with a record, or crashed ones
 	
-	std::vector<CStats> optimum;
+	//the per-parameter statistics, which may be streaming, see Prepare_Solver_Result
+	std::vector<CSample_Stats> optimum;
 	CStats optimum_fitness;
 
-	std::vector<CStats> parameters;
+	std::vector<CSample_Stats> parameters;
 	CStats fitness;
 
 	CStats fitness_error;
-	CStats abs_parameter_error;
-	CStats abs_parameter_error_001;
+	CSample_Stats abs_parameter_error;
+	CSample_Stats abs_parameter_error_001;
+	CStats run_parameter_error;	//the mean abs_parameter_error of each run
 
 	CStats total_objective_calls;
 	CStats least_objective_call;
 	CStats least_objective_call_001;
 
 	CStats seconds;
+	CStats generations;	//as reported by the solver's progress
+	CStats evaluations_per_second;
+	CStats objective_seconds;	//time spent inside the objective function
+	CStats overhead_seconds;	//seconds minus objective_seconds, i.e., solver's own time
+	CStats call_latency_p50, call_latency_p99;	//nanoseconds per a single objective call
+	CStats cache_hits, cache_misses;	//of the fitness cache, the misses are the real objective calls
+	CStats time_budget_used, evaluation_budget_used;	//fractions of the run's budgets
+	CStats cycles_per_evaluation, instructions_per_evaluation, instructions_per_cycle;	//of the hardware performance counters, see CPerf_Counters
+	CStats l1d_misses_per_evaluation, llc_misses_per_evaluation, branch_misses_per_evaluation;
+	CStats context_switches;
+	CStats allocations, allocated_bytes, peak_live_bytes, allocations_per_evaluation, peak_rss_delta_bytes;	//see CAllocation_Scope
+	CStats cpu_seconds, cpu_migrations, disturbed;	//of the low-noise timing, see TTiming_Setup; disturbed is 0 or 1 per run
+	std::array<size_t, static_cast<size_t>(NStop_Reason::count)> stop_reasons{};	//number of runs per stop reason
+
+	std::vector<std::vector<TConvergence_Point>> convergence;	//per run, fitness relative to the optimum fitness
 	std::wstring name;
+	GUID solver_id = Invalid_GUID;
+	size_t population_size = 0;
+};
+
+//a cell, which failed without a run, is stored as a marker record, so that a merge of the shards counts the same fails
+enum class NFail_Marker : size_t {
+	None = 0,	//a run
+	Crashed,	//the isolated run has crashed, counts as a failed repetition
+	Faulty		//the solver is known to be faulty for the problem size, counts as a fail only
+};
+
+//outcome of a single Run_Solver call, i.e., of one (problem, population size, repetition, solver) cell
+struct TRun_Record {
+	GUID solver_id = Invalid_GUID;
+	std::wstring solver_name;	//the same as TSolver_Result::name
+	std::string problem_name;
+	size_t problem_ordinal = 0, problem_size = 0, population_size = 0, repetition = 0;
+	uint64_t shift_fingerprint = 0;	//identifies the problem instance, i.e., its optimum
+	uint64_t build_hash = 0;	//identifies the build of the solvers, 0 if unknown
+	size_t max_generations = 0;	//the limits of the run, 0 if unknown
+	TRun_Budget budget;
+	size_t distributed_workers = 0;	//of the distributed solver's run, 0 for the other solvers
+	bool randomized = false;	//the campaign randomizes the optimum in each repetition
+
+	NFail_Marker fail_marker = NFail_Marker::None;	//no metrics are set for a marker
+
+	bool failed = false;
+	NStop_Reason stop_reason = NStop_Reason::Completed;
+
+	double optimum_fitness = std::numeric_limits<double>::quiet_NaN();
+	double fitness = std::numeric_limits<double>::quiet_NaN();
+	double fitness_error = std::numeric_limits<double>::quiet_NaN();
+
+	double total_objective_calls = std::numeric_limits<double>::quiet_NaN();
+	double least_objective_call = std::numeric_limits<double>::quiet_NaN();
+	double least_objective_call_001 = std::numeric_limits<double>::quiet_NaN();
+
+	double seconds = std::numeric_limits<double>::quiet_NaN();
+	double generations = std::numeric_limits<double>::quiet_NaN();
+	double evaluations_per_second = std::numeric_limits<double>::quiet_NaN();
+	double objective_seconds = std::numeric_limits<double>::quiet_NaN();
+	double overhead_seconds = std::numeric_limits<double>::quiet_NaN();
+	double call_latency_p50 = std::numeric_limits<double>::quiet_NaN();
+	double call_latency_p99 = std::numeric_limits<double>::quiet_NaN();
+	double cache_hits = std::numeric_limits<double>::quiet_NaN();	//NaN, if the fitness cache is disabled
+	double cache_misses = std::numeric_limits<double>::quiet_NaN();
+	double time_budget_used = std::numeric_limits<double>::quiet_NaN();	//NaN, if the budget is unlimited
+	double evaluation_budget_used = std::numeric_limits<double>::quiet_NaN();
+	double cycles_per_evaluation = std::numeric_limits<double>::quiet_NaN();	//NaN, if the performance counters are disabled or not available
+	double instructions_per_evaluation = std::numeric_limits<double>::quiet_NaN();
+	double instructions_per_cycle = std::numeric_limits<double>::quiet_NaN();
+	double l1d_misses_per_evaluation = std::numeric_limits<double>::quiet_NaN();
+	double llc_misses_per_evaluation = std::numeric_limits<double>::quiet_NaN();
+	double branch_misses_per_evaluation = std::numeric_limits<double>::quiet_NaN();
+	double context_switches = std::numeric_limits<double>::quiet_NaN();
+	double allocations = std::numeric_limits<double>::quiet_NaN();	//NaN, if the memory profile is disabled or not available
+	double allocated_bytes = std::numeric_limits<double>::quiet_NaN();
+	double peak_live_bytes = std::numeric_limits<double>::quiet_NaN();
+	double allocations_per_evaluation = std::numeric_limits<double>::quiet_NaN();
+	double peak_rss_delta_bytes = std::numeric_limits<double>::quiet_NaN();
+	double cpu_seconds = std::numeric_limits<double>::quiet_NaN();	//NaN, unless the low-noise timing is enabled
+	double cpu_migrations = std::numeric_limits<double>::quiet_NaN();
+	double disturbed = std::numeric_limits<double>::quiet_NaN();	//1, if the run has migrated or its core has changed the frequency
+
+	std::vector<double> optimum, parameters, parameters_001;
+	std::vector<TConvergence_Point> convergence;	//best-so-far fitness error, i.e., |fitness - optimum_fitness|, at log-spaced calls
+};
+
+//scalar metrics, which have a column in both TRun_Record and TSolver_Result
+struct TRun_Metric {
+	const char* name;
+	double TRun_Record::* value;
+	CStats TSolver_Result::* stats;
+};
+
+extern const std::vector<TRun_Metric> Run_Metrics;
+
+void Prepare_Solver_Result(TSolver_Result &result, const size_t problem_size, const bool streaming);	//streaming - CStreaming_Stats for the per-parameter statistics
+void Append_Run_Record(TSolver_Result &result, const TRun_Record &record);
+
+
+struct TProblem_Info {
+	std::string name;
+	size_t ordinal = 0, size = 0;
+	bool randomized = false;
 };
 
+class IResult_Sink;
+class CResult_Store;
+
+//Instead of a fixed count, the repetitions of a solver continue only until its ranking is settled, at most the repetitions given.
+//A solver is settled, once the confidence intervals of its abs_parameter_error, fitness_error and least_objective_call_001 means
+//are narrow enough, or once the Mann-Whitney test tells it from the current leader by the runs' abs_parameter_error.
+struct TAdaptive_Repetitions {
+	bool enabled = false;
+	size_t min_repetitions = 5;
+	double relative_ci_width = 0.1;	//95% confidence interval's half-width relative to the mean
+	double alpha = 0.05;	//of the leader test, divided among all the looks, i.e., Bonferroni
+};
+
+struct TCampaign_Options {
+	//the grid of the cells; the empty lists select the defaults of Run_Solvers
+	std::vector<std::wstring> solvers;	//GUIDs or descriptions
+	std::vector<size_t> population_sizes;
+	size_t max_generations = 100'000;
+	size_t shard_index = 0, shard_count = 1;	//runs only the cells of the shard_index-th of shard_count disjoint parts
+
+	bool randomize_optimum = false;
+	size_t parallel_workers = 0;	//0 - runs all the cells sequentially on a single working problem, otherwise the number of the work-stealing pool threads
+	std::shared_ptr<IResult_Sink> sink;	//receives each run as it completes and the final results; nullptr prints the csv report only
+	std::shared_ptr<CResult_Store> store;	//runs already completed in the store are reloaded instead of being run again
+	size_t fitness_cache_entries = 0;	//0 disables the fitness cache of the local solvers, see CFitness_Cache
+	TRun_Budget budget;	//of each run
+	bool isolated = false;	//each run executes in its own child process, so that a crash or a hang of a solver fails that run only
+	TIsolation_Limits isolation;
+	bool perf_counters = false;	//measures each run with the hardware performance counters, where available
+	bool memory_profile = false;	//counts the allocations of each run, see CAllocation_Scope
+	TTiming_Setup timing;
+	TAdaptive_Repetitions adaptive;	//not with the shards, as it needs all the cells of a solver
+	bool streaming_stats = false;	//the per-parameter statistics of the report in fixed memory, with the estimated quartiles
+	TIsland_Setup islands;	//of the island model meta-solver; the empty solvers select the registered ones of a default set
+	std::string build_id;	//distinguishes builds of the solver libraries, which this executable cannot tell apart by their files, e.g., their version control revision
+
+	//distributed solver setup
+	std::string distributed_library = "tproblem_udp";
+	std::string distributed_address = "tcp://localhost:5000";
+	size_t distributed_workers = 8;
+	std::string controller_command, worker_command;	//if set, a local controller and the workers are spawned, see CLocal_Cluster
+	size_t cluster_startup_ms = 1000;
+	bool sweep_distributed_workers = false;
+
+	//problem size sweep, see Sweep_Problem_Sizes
+	bool sweep_problem_sizes = false;
+	double sweep_budget_seconds = std::numeric_limits<double>::infinity();	//of a solver's median run, measured or predicted for the next size
+};
+
+bool Is_Solver_Allowed(const scgms::TSolver_Descriptor &solver);	//diagnostic::allowed_solvers, when debugging
+bool Is_Solver_Faulty(const GUID &solver_id, const size_t problem_size);	//the solver is known to fail on problems of this size
+
+std::vector<TSolver_Result> Run_Solvers(size_t repetitions, CCommon_Problem *problem, const TProblem_Info &problem_info, const TCampaign_Options &options);
+
+
+//calculates the stats, sorts the results from the best solver and hands them to the sink; also used when merging stores
+void Report_Results(const TProblem_Info &problem_info, std::vector<TSolver_Result> &results, IResult_Sink &sink);
 
-void Evaluate_Solvers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, bool randomize_optimum);
\ No newline at end of file
+//returns the reported results, i.e., with their stats calculated
+std::vector<TSolver_Result> Evaluate_Solvers(CCommon_Problem *problem, const size_t repetitions, const size_t problem_ordinal_number, const TCampaign_Options &options);
\ No newline at end of file
@@ -39,6 +39,7 @@
 #include "stats.h"
 
 #include <algorithm>
+#include <cmath>
 
 
 void CStats::Calculate_Stats() {
@@ -102,4 +103,272 @@ void CStats::Calculate_Stats() {
 
 const TStats& CStats::Get_Stats() const {
 	return mStats;
-}
\ No newline at end of file
+}
+
+CStreaming_Stats::CStreaming_Stats() {
+	mCentroids.reserve(2 * Compression + 1);
+	mBuffer.reserve(Buffer_Size + mCentroids.capacity());	//Compress appends the centroids to the buffer
+}
+
+void CStreaming_Stats::push_back(const double value) {
+	if (std::isnan(value)) return;	//would break the ordering of the digest
+
+	mCount++;
+	const double delta = value - mMean;
+	mMean += delta / static_cast<double>(mCount);
+	mM2 += delta * (value - mMean);
+
+	if (mCount == 1) mMin = mMax = value;
+	else {
+		if (value < mMin) mMin = value;
+		if (value > mMax) mMax = value;
+	}
+
+	mBuffer.push_back({ value, 1.0 });
+	if (mBuffer.size() >= Buffer_Size) Compress();
+}
+
+void CStreaming_Stats::Merge(const CStreaming_Stats &other) {
+	if (other.mCount == 0) return;
+
+	if (mCount == 0) {
+		mMin = other.mMin;
+		mMax = other.mMax;
+	} else {
+		if (other.mMin < mMin) mMin = other.mMin;
+		if (other.mMax > mMax) mMax = other.mMax;
+	}
+
+	//Chan et al. parallel variant of the Welford's update
+	const double n_a = static_cast<double>(mCount);
+	const double n_b = static_cast<double>(other.mCount);
+	const double delta = other.mMean - mMean;
+	mCount += other.mCount;
+	mMean += delta * n_b / static_cast<double>(mCount);
+	mM2 += other.mM2 + delta * delta * n_a * n_b / static_cast<double>(mCount);
+
+	//feed the other digest's centroids as weighted samples
+	auto feed = [this](const TCentroid &centroid) {
+		mBuffer.push_back(centroid);
+		if (mBuffer.size() >= Buffer_Size) Compress();
+	};
+	for (const auto &centroid : other.mCentroids) feed(centroid);
+	for (const auto &centroid : other.mBuffer) feed(centroid);
+}
+
+void CStreaming_Stats::Compress() {
+	if (mBuffer.empty()) return;
+
+	mBuffer.insert(mBuffer.end(), mCentroids.begin(), mCentroids.end());
+	std::sort(mBuffer.begin(), mBuffer.end(), [](const TCentroid &a, const TCentroid &b) { return a.mean < b.mean; });
+
+	double total_weight = 0.0;
+	for (const auto &centroid : mBuffer)
+		total_weight += centroid.weight;
+
+	//k1 scale function - keeps the centroids small at the tails and large around the median
+	const double pi = 3.14159265358979323846;
+	auto k_scale = [pi](const double q) { return static_cast<double>(Compression) / (2.0 * pi) * std::asin(2.0 * q - 1.0); };
+
+	mCentroids.clear();
+	TCentroid current = mBuffer[0];
+	double weight_so_far = 0.0;	//weight left of the current centroid
+	double k_left = k_scale(0.0);
+	for (size_t i = 1; i < mBuffer.size(); i++) {
+		const auto &next = mBuffer[i];
+		const double q_right = std::min((weight_so_far + current.weight + next.weight) / total_weight, 1.0);
+
+		if (k_scale(q_right) - k_left <= 1.0) {
+			current.weight += next.weight;
+			current.mean += (next.mean - current.mean) * next.weight / current.weight;
+		} else {
+			weight_so_far += current.weight;
+			k_left = k_scale(std::min(weight_so_far / total_weight, 1.0));
+			mCentroids.push_back(current);
+			current = next;
+		}
+	}
+	mCentroids.push_back(current);
+
+	mBuffer.clear();
+}
+
+double CStreaming_Stats::Quantile(const double q) const {
+	if (mCentroids.size() == 1) return mCentroids[0].mean;
+
+	const double total_weight = static_cast<double>(mCount);
+	const double rank = q * total_weight;
+
+	//each centroid represents its weight spread evenly around its mean, min and max anchor the both ends
+	double weight_so_far = 0.0;
+	double previous_mean = mMin, previous_rank = 0.0;
+	for (const auto &centroid : mCentroids) {
+		const double center_rank = weight_so_far + centroid.weight * 0.5;
+		if (rank <= center_rank) {
+			const double span = center_rank - previous_rank;
+			return span > 0.0 ? previous_mean + (centroid.mean - previous_mean) * (rank - previous_rank) / span : centroid.mean;
+		}
+
+		weight_so_far += centroid.weight;
+		previous_mean = centroid.mean;
+		previous_rank = center_rank;
+	}
+
+	const double span = total_weight - previous_rank;
+	return span > 0.0 ? previous_mean + (mMax - previous_mean) * (rank - previous_rank) / span : mMax;
+}
+
+void CStreaming_Stats::Calculate_Stats() {
+	mStats = TStats{};
+
+	if (mCount == 0) return;
+
+	Compress();
+	mStats.min = mMin;
+	mStats.max = mMax;
+	if (mMin != mMax) {
+		mStats.q25 = Quantile(0.25);
+		mStats.med = Quantile(0.5);
+		mStats.q75 = Quantile(0.75);
+		mStats.avg = mMean;
+
+		//the same correction as CStats uses
+		double N = static_cast<double>(mCount);
+		if (N > 1.5) N -= 1.5;
+		else if (N > 1.0) N -= 1.0;
+
+		mStats.stddev = sqrt(mM2 / N);
+	} else {
+		mStats.q25 = mStats.med = mStats.q75 = mStats.avg = mMin;
+		mStats.stddev = 0.0;
+	}
+}
+
+const TStats& CStreaming_Stats::Get_Stats() const {
+	return mStats;
+}
+
+size_t CStreaming_Stats::size() const {
+	return mCount;
+}
+
+bool CStreaming_Stats::empty() const {
+	return mCount == 0;
+}
+
+
+void CSample_Stats::Use_Streaming() {
+	if (mStreaming) return;
+
+	mStreaming.emplace();
+	for (const double value : mSamples)
+		mStreaming->push_back(value);
+	mSamples = CStats{};
+}
+
+bool CSample_Stats::Is_Streaming() const {
+	return mStreaming.has_value();
+}
+
+void CSample_Stats::push_back(const double value) {
+	if (mStreaming) mStreaming->push_back(value);
+	else mSamples.push_back(value);
+}
+
+void CSample_Stats::Merge(const CSample_Stats &other) {
+	if (other.mStreaming) {
+		Use_Streaming();
+		mStreaming->Merge(*other.mStreaming);
+	}
+	else {
+		for (const double value : other.mSamples)
+			push_back(value);
+	}
+}
+
+size_t CSample_Stats::size() const {
+	return mStreaming ? mStreaming->size() : mSamples.size();
+}
+
+void CSample_Stats::Calculate_Stats() {
+	if (mStreaming) mStreaming->Calculate_Stats();
+	else mSamples.Calculate_Stats();
+}
+
+const TStats& CSample_Stats::Get_Stats() const {
+	return mStreaming ? mStreaming->Get_Stats() : mSamples.Get_Stats();
+}
+
+
+double Mean_Confidence_Half_Width(const std::vector<double> &values) {
+	//t(0.975, df) for df = 1..30, the normal quantile beyond
+	static const double t_quantiles[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+										  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+										  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+	size_t count = 0;
+	double mean = 0.0, m2 = 0.0;
+	for (const double value : values) {
+		if (std::isnan(value)) continue;
+		count++;
+		const double delta = value - mean;
+		mean += delta / static_cast<double>(count);
+		m2 += delta * (value - mean);
+	}
+	if (count < 2) return std::numeric_limits<double>::quiet_NaN();
+
+	const size_t df = count - 1;
+	const double t = df <= 30 ? t_quantiles[df - 1] : 1.960;
+	return t * std::sqrt(m2 / static_cast<double>(df)) / std::sqrt(static_cast<double>(count));
+}
+
+double Mann_Whitney_P_Value(const std::vector<double> &a, const std::vector<double> &b) {
+	std::vector<std::pair<double, bool>> pooled;	//value, is from a
+	for (const double value : a)
+		if (!std::isnan(value)) pooled.push_back({ value, true });
+	const double n1 = static_cast<double>(pooled.size());
+	for (const double value : b)
+		if (!std::isnan(value)) pooled.push_back({ value, false });
+	const double n2 = static_cast<double>(pooled.size()) - n1;
+	if ((n1 == 0.0) || (n2 == 0.0)) return 1.0;
+
+	std::sort(pooled.begin(), pooled.end(), [](const auto &x, const auto &y) { return x.first < y.first; });
+
+	//mid-ranks of the ties
+	double rank_sum = 0.0, tie_term = 0.0;
+	for (size_t i = 0; i < pooled.size(); ) {
+		size_t j = i;
+		while ((j < pooled.size()) && (pooled[j].first == pooled[i].first)) j++;
+
+		const double rank = 0.5 * static_cast<double>(i + j + 1);	//1-based ranks i+1..j
+		for (size_t k = i; k < j; k++)
+			if (pooled[k].second) rank_sum += rank;
+
+		const double ties = static_cast<double>(j - i);
+		tie_term += ties * ties * ties - ties;
+		i = j;
+	}
+
+	const double n = n1 + n2;
+	const double u = rank_sum - n1 * (n1 + 1.0) * 0.5;
+	const double variance = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+	if (variance <= 0.0) return 1.0;	//all the values are equal
+
+	const double z = (std::fabs(u - n1 * n2 * 0.5) - 0.5) / std::sqrt(variance);	//with the continuity correction
+	return z > 0.0 ? std::erfc(z / std::sqrt(2.0)) : 1.0;
+}
+
+double Cliffs_Delta(const std::vector<double> &a, const std::vector<double> &b) {
+	double greater = 0.0, less = 0.0, pairs = 0.0;
+	for (const double x : a) {
+		if (std::isnan(x)) continue;
+		for (const double y : b) {
+			if (std::isnan(y)) continue;
+			if (x > y) greater += 1.0;
+			else if (x < y) less += 1.0;
+			pairs += 1.0;
+		}
+	}
+
+	return pairs > 0.0 ? (greater - less) / pairs : std::numeric_limits<double>::quiet_NaN();
+}
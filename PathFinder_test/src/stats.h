@@ -42,6 +42,9 @@
 
 #include <vector>
 #include <utility>
+#include <limits>
+#include <optional>
+#include <cstddef>
 
 struct TStats {
 	double avg = std::numeric_limits<double>::quiet_NaN(), stddev = std::numeric_limits<double>::quiet_NaN();
@@ -56,4 +59,67 @@ protected:
 public:
 	void Calculate_Stats();	//fills mStats depending on current values
 	const TStats& Get_Stats() const;		//returns mStats
-};
\ No newline at end of file
+};
+
+//Fixed-memory alternative to CStats, which does not keep the samples.
+//Moments are updated online (Welford), quartiles are estimated with a merging t-digest.
+//Partial statistics, e.g., of parallel workers, can be combined with Merge.
+class CStreaming_Stats {
+public:
+	static constexpr size_t Compression = 100;	//t-digest delta; the digest keeps at most ~2*Compression centroids
+	static constexpr size_t Buffer_Size = 4 * Compression;
+protected:
+	struct TCentroid {
+		double mean, weight;
+	};
+
+	size_t mCount = 0;
+	double mMean = 0.0, mM2 = 0.0;	//Welford's running mean and the sum of squared deviations
+	double mMin = std::numeric_limits<double>::quiet_NaN(), mMax = std::numeric_limits<double>::quiet_NaN();
+
+	std::vector<TCentroid> mCentroids;
+	std::vector<TCentroid> mBuffer;	//unmerged samples, compressed once full
+
+	TStats mStats;
+
+	void Compress();
+	double Quantile(const double q) const;	//requires compressed digest
+public:
+	CStreaming_Stats();
+
+	void push_back(const double value);
+	void Merge(const CStreaming_Stats &other);
+	size_t size() const;
+	bool empty() const;
+
+	void Calculate_Stats();	//fills mStats depending on current values
+	const TStats& Get_Stats() const;		//returns mStats
+};
+
+//CStats, or CStreaming_Stats once Use_Streaming is called before the first sample, e.g., for the per-parameter statistics,
+//whose samples would take the memory of the repetitions times the problem size
+class CSample_Stats {
+protected:
+	CStats mSamples;
+	std::optional<CStreaming_Stats> mStreaming;
+public:
+	void Use_Streaming();
+	bool Is_Streaming() const;
+
+	void push_back(const double value);
+	void Merge(const CSample_Stats &other);	//becomes streaming, if the other is
+	size_t size() const;
+
+	void Calculate_Stats();
+	const TStats& Get_Stats() const;
+};
+
+//half-width of the 95% confidence interval of the mean, by Student's t; NaN values are ignored, NaN for less than 2 values
+double Mean_Confidence_Half_Width(const std::vector<double> &values);
+
+//two-sided p-value of the Mann-Whitney U test, i.e., whether the values of a tend to differ from those of b;
+//by the normal approximation with the tie correction, NaN values are ignored, 1 if either has no value
+double Mann_Whitney_P_Value(const std::vector<double> &a, const std::vector<double> &b);
+
+//Cliff's delta, the effect size of the Mann-Whitney test, i.e., P(a > b) - P(a < b) within -1..1; NaN values are ignored, NaN if either has no value
+double Cliffs_Delta(const std::vector<double> &a, const std::vector<double> &b);
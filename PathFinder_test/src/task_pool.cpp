@@ -0,0 +1,101 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "task_pool.h"
+
+#include <thread>
+#include <algorithm>
+
+CWork_Stealing_Pool::CWork_Stealing_Pool(const size_t worker_count) : mWorker_Count(std::max(worker_count, static_cast<size_t>(1))) {
+	for (size_t i = 0; i < mWorker_Count; i++)
+		mQueues.push_back(std::make_unique<TWorker_Queue>());
+}
+
+size_t CWork_Stealing_Pool::Worker_Count() const {
+	return mWorker_Count;
+}
+
+bool CWork_Stealing_Pool::Pop_Own(const size_t worker_index, TTask &task) {
+	auto &queue = *mQueues[worker_index];
+	std::lock_guard<std::mutex> lock{ queue.lock };
+	if (queue.tasks.empty()) return false;
+
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	return true;
+}
+
+bool CWork_Stealing_Pool::Steal(const size_t worker_index, TTask &task) {
+	//start with the neighbor so that the thieves do not all hammer the very same queue
+	for (size_t i = 1; i < mWorker_Count; i++) {
+		auto &queue = *mQueues[(worker_index + i) % mWorker_Count];
+		std::lock_guard<std::mutex> lock{ queue.lock };
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CWork_Stealing_Pool::Worker(const size_t worker_index) {
+	TTask task;
+	//no task is ever added during the execution => once there is nothing to steal, we are done
+	while (Pop_Own(worker_index, task) || Steal(worker_index, task)) {
+		task(worker_index);
+		task = nullptr;
+	}
+}
+
+void CWork_Stealing_Pool::Execute(std::vector<TTask> &tasks) {
+	//deal the tasks in reverse round-robin order, so that each worker pops its tasks in the submission order
+	for (size_t i = tasks.size(); i > 0; i--)
+		mQueues[(i - 1) % mWorker_Count]->tasks.push_back(std::move(tasks[i - 1]));
+	tasks.clear();
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < mWorker_Count; i++)
+		threads.push_back(std::thread{ &CWork_Stealing_Pool::Worker, this, i });
+
+	Worker(0);	//the calling thread works as well
+
+	for (auto &thread : threads)
+		thread.join();
+}
@@ -0,0 +1,70 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+//Executes a fixed set of tasks on a number of worker threads.
+//Each worker owns a queue; once it drains it, it steals from the other workers' queues,
+//so that a few long-running cells do not leave the remaining workers idle.
+class CWork_Stealing_Pool {
+public:
+	using TTask = std::function<void(const size_t worker_index)>;	//worker_index is in [0, Worker_Count())
+protected:
+	struct TWorker_Queue {
+		std::mutex lock;
+		std::deque<TTask> tasks;
+	};
+
+	const size_t mWorker_Count;
+	std::vector<std::unique_ptr<TWorker_Queue>> mQueues;
+
+	bool Pop_Own(const size_t worker_index, TTask &task);	//LIFO end of the own queue
+	bool Steal(const size_t worker_index, TTask &task);		//FIFO end of the other queues
+	void Worker(const size_t worker_index);
+public:
+	CWork_Stealing_Pool(const size_t worker_count);
+
+	size_t Worker_Count() const;
+	void Execute(std::vector<TTask> &tasks);	//blocks until all the tasks are done; tasks must not throw
+};
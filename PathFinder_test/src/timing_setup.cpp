@@ -0,0 +1,181 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "timing_setup.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#ifdef _WIN32
+	#include <Windows.h>
+#else
+	#include <ctime>
+	#include <fstream>
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/syscall.h>
+#endif
+
+bool Parse_CPU_Set(const std::string &text, std::vector<size_t> &cpus) {
+	cpus.clear();
+
+	size_t pos = 0;
+	while (pos < text.size()) {
+		size_t comma = text.find(',', pos);
+		if (comma == std::string::npos) comma = text.size();
+		const std::string item = text.substr(pos, comma - pos);
+		pos = comma + 1;
+
+		char *end = nullptr;
+		const size_t first = std::strtoul(item.c_str(), &end, 10);
+		if (end == item.c_str()) return false;
+		size_t last = first;
+		if (*end == '-') {
+			const char *high = end + 1;
+			last = std::strtoul(high, &end, 10);
+			if ((end == high) || (last < first)) return false;
+		}
+		if (*end != 0) return false;
+
+		for (size_t cpu = first; cpu <= last; cpu++)
+			cpus.push_back(cpu);
+	}
+
+	return !cpus.empty();
+}
+
+bool Pin_Current_Thread(const std::vector<size_t> &cpus, const bool numa_local) {
+	if (cpus.empty()) return false;
+
+#ifdef _WIN32
+	DWORD_PTR mask = 0;
+	for (const size_t cpu : cpus)
+		if (cpu < sizeof(DWORD_PTR) * 8) mask |= static_cast<DWORD_PTR>(1) << cpu;
+	return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;	//Windows allocates node-locally by default
+#else
+	#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (const size_t cpu : cpus)
+			if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) != 0) return false;
+
+		if (numa_local) {
+			constexpr int mpol_local = 4;	//MPOL_LOCAL of numaif.h, i.e., the node of the allocating cpu
+			syscall(SYS_set_mempolicy, mpol_local, nullptr, 0);	//best effort, fails on kernels without NUMA
+		}
+		return true;
+	#else
+		return false;
+	#endif
+#endif
+}
+
+void Warm_Up_Problem(CCommon_Problem *problem, const CSolution &lower_bound, const CSolution &upper_bound, const size_t evaluations) {
+	if (evaluations == 0) return;
+
+	std::mt19937_64 random_generator{ 20181 };
+	std::vector<double> candidate(lower_bound.size());
+	volatile double sink = 0.0;	//keeps the discarded evaluations alive
+	for (size_t e = 0; e < evaluations; e++) {
+		for (size_t d = 0; d < candidate.size(); d++)
+			candidate[d] = std::uniform_real_distribution<double>{ lower_bound[d], upper_bound[d] }(random_generator);
+		sink = sink + problem->Calculate_Fitness(candidate.data());
+	}
+
+	problem->reset_counters();	//the run must not see the warm-up calls
+}
+
+namespace {
+	double CPU_Seconds(const bool process_wide) {
+#ifdef _WIN32
+		FILETIME creation, exit, kernel, user;
+		const BOOL ok = process_wide ? GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user) : GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+		if (!ok) return std::numeric_limits<double>::quiet_NaN();
+		auto to_seconds = [](const FILETIME &time) { return static_cast<double>((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) * 1e-7; };
+		return to_seconds(kernel) + to_seconds(user);
+#else
+		timespec time;
+		if (clock_gettime(process_wide ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID, &time) != 0) return std::numeric_limits<double>::quiet_NaN();
+		return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+#endif
+	}
+
+	int Current_CPU() {
+#ifdef __linux__
+		return sched_getcpu();
+#else
+		return -1;
+#endif
+	}
+
+	//kHz, NaN, if the cpufreq is not exposed, e.g., in a virtual machine
+	double CPU_Frequency(const int cpu) {
+#ifdef __linux__
+		if (cpu < 0) return std::numeric_limits<double>::quiet_NaN();
+		std::ifstream file{ "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq" };
+		double frequency = std::numeric_limits<double>::quiet_NaN();
+		if (!(file >> frequency)) return std::numeric_limits<double>::quiet_NaN();
+		return frequency;
+#else
+		return std::numeric_limits<double>::quiet_NaN();
+#endif
+	}
+}
+
+CTiming_Probe::CTiming_Probe(const bool process_wide, const double frequency_tolerance) : mProcess_Wide(process_wide), mFrequency_Tolerance(frequency_tolerance) {
+}
+
+void CTiming_Probe::Start() {
+	mStart_CPU = Current_CPU();
+	mStart_Frequency = CPU_Frequency(mStart_CPU);
+	mStart_CPU_Seconds = CPU_Seconds(mProcess_Wide);	//the last one, so that reading the frequency does not count
+}
+
+TTiming_Sample CTiming_Probe::Stop() {
+	TTiming_Sample sample;
+	sample.cpu_seconds = CPU_Seconds(mProcess_Wide) - mStart_CPU_Seconds;
+
+	const int cpu = Current_CPU();
+	sample.migrated = cpu != mStart_CPU;
+	const double frequency = CPU_Frequency(cpu);
+	sample.frequency_changed = !sample.migrated && (std::fabs(frequency - mStart_Frequency) > mFrequency_Tolerance * mStart_Frequency);	//false for NaN
+
+	return sample;
+}
@@ -0,0 +1,84 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#pragma once
+
+#include "TProblemData.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+//Low-noise timing of the runs, which are otherwise exposed to migrations, frequency scaling and cold caches.
+struct TTiming_Setup {
+	bool enabled = false;	//measures the cpu time and flags the disturbed runs
+	std::vector<size_t> cpus;	//the core set to pin to, empty - not pinned; a parallel worker gets a single core of the set
+	bool numa_local = false;	//a pinned thread prefers the memory of its own node
+	size_t warm_up_evaluations = 0;	//discarded objective calls before each run
+	double frequency_tolerance = 0.1;	//relative change of the core's frequency during a run, which flags the run as disturbed
+};
+
+//parses a cpu list such as "0-3,6"
+bool Parse_CPU_Set(const std::string &text, std::vector<size_t> &cpus);
+
+//false, if the thread could not be pinned, e.g., the set is not allowed or it is not supported on this platform
+bool Pin_Current_Thread(const std::vector<size_t> &cpus, const bool numa_local);
+
+//evaluates deterministic pseudo-random candidates within the bounds to warm up the caches, then resets the problem's counters
+void Warm_Up_Problem(CCommon_Problem *problem, const CSolution &lower_bound, const CSolution &upper_bound, const size_t evaluations);
+
+struct TTiming_Sample {
+	double cpu_seconds = std::numeric_limits<double>::quiet_NaN();
+	bool migrated = false;	//the thread has ended on another cpu than it started on
+	bool frequency_changed = false;
+};
+
+//CPU time of the calling thread, or of the whole process, and the frequency of the core the thread runs on at the start and at the stop.
+class CTiming_Probe {
+protected:
+	const bool mProcess_Wide;
+	const double mFrequency_Tolerance;
+	double mStart_CPU_Seconds = std::numeric_limits<double>::quiet_NaN();
+	int mStart_CPU = -1;
+	double mStart_Frequency = std::numeric_limits<double>::quiet_NaN();
+public:
+	CTiming_Probe(const bool process_wide, const double frequency_tolerance);
+
+	void Start();
+	TTiming_Sample Stop();
+};
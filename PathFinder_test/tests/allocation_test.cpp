@@ -0,0 +1,136 @@
+/**
+ * SmartCGMS - continuous glucose monitoring and controlling framework
+ * https://diabetes.zcu.cz/
+ *
+ * Copyright (c) since 2018 University of West Bohemia.
+ *
+ * Contact:
+ * diabetes@mail.kiv.zcu.cz
+ * Medical Informatics, Department of Computer Science and Engineering
+ * Faculty of Applied Sciences, University of West Bohemia
+ * Univerzitni 8, 301 00 Pilsen
+ * Czech Republic
+ *
+ *
+ * Purpose of this software:
+ * This software is intended to demonstrate work of the diabetes.zcu.cz research
+ * group to other scientists, to complement our published papers. It is strictly
+ * prohibited to use this software for diagnosis or treatment of any medical condition,
+ * without obtaining all required approvals from respective regulatory bodies.
+ *
+ * Especially, a diabetic patient is warned that unauthorized use of this software
+ * may result into severe injure, including death.
+ *
+ *
+ * Licensing terms:
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under these license terms is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * a) For non-profit, academic research, this software is available under the
+ *      GPLv3 license.
+ * b) For any other use, especially commercial use, you must contact us and
+ *       obtain specific terms and conditions for the use of the software.
+ * c) When publishing work with results obtained using this software, you agree to cite the following paper:
+ *       Tomas Koutny and Martin Ubl, "Parallel software architecture for the next generation of glucose
+ *       monitoring", Procedia Computer Science, Volume 141C, pp. 279-286, 2018
+ */
+
+#include "../src/objective.h"
+#include "../src/memory_profile.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+//Asserts, that the objective's hot path does not allocate in the steady state, i.e., once warmed up:
+//the problems' Calculate_Fitness with its best-solution tracking, the best-so-far trace of a run and the objective's batch paths.
+//Exits with 77, i.e., skipped, where the allocations cannot be counted.
+
+namespace {
+	constexpr int Skipped = 77;
+	constexpr size_t Problem_Size = 10;
+	constexpr size_t Calls = 4096;
+
+	//candidates approaching the optimum, so that each call improves the problem's best solution
+	void Approach_Optimum(const CSolution &optimum, const CSolution &start, const double from, const double to, std::vector<double> &candidates) {
+		candidates.resize(Calls * Problem_Size);
+		for (size_t i = 0; i < Calls; i++) {
+			const double distance = from * std::pow(to / from, static_cast<double>(i) / static_cast<double>(Calls - 1));
+			for (size_t d = 0; d < Problem_Size; d++)
+				candidates[i * Problem_Size + d] = optimum[d] + (start[d] - optimum[d]) * distance;
+		}
+	}
+
+	bool Check(const char* problem, const char* path, const double allocations) {
+		const bool ok = allocations == 0.0;
+		std::cout << problem << "; " << path << "; " << allocations << (ok ? "" : "; allocates") << std::endl;
+		return ok;
+	}
+}
+
+int __cdecl main() {
+	{
+		CAllocation_Scope probe{ false };
+		probe.Start();
+		if (std::isnan(probe.Stop().allocations)) {
+			std::cout << "The allocations cannot be counted on this platform, skipped." << std::endl;
+			return Skipped;
+		}
+	}
+
+	size_t failed = 0;
+	std::mt19937_64 random_generator{ 20181 };
+	std::vector<double> warm_up, measured;
+
+	std::cout << "problem; path; allocations" << std::endl;
+	const auto problems = Create_Problem_Collection(Problem_Size);
+	for (const auto &problem : problems) {
+		if (!problem->Can_Be_Solved()) continue;
+		const std::string name = problem->Get_Name();
+
+		CSolution lower_bound, upper_bound, optimum, start;
+		double optimum_fitness;
+		problem->get_bounds(lower_bound, upper_bound);
+		problem->get_optimum(optimum, optimum_fitness);
+		start.resize(Problem_Size);
+		for (size_t d = 0; d < Problem_Size; d++)
+			start[d] = std::uniform_real_distribution<double>{ lower_bound[d], upper_bound[d] }(random_generator);
+
+		//the warm-up takes the problem's best below its 1% threshold, the measured calls keep improving it
+		Approach_Optimum(optimum, start, 1.0, 1e-3, warm_up);
+		Approach_Optimum(optimum, start, 1e-3, 1e-9, measured);
+		for (size_t i = 0; i < Calls; i++)
+			problem->Calculate_Fitness(warm_up.data() + i * Problem_Size);
+
+		CSolution parameters_001;
+		double total_calls, least_call, least_call_001;
+		problem->Get_Objective_Calls(total_calls, least_call, least_call_001, parameters_001);
+
+		CAllocation_Scope scope{ false };
+		scope.Start();
+		for (size_t i = 0; i < Calls; i++)
+			problem->Calculate_Fitness(measured.data() + i * Problem_Size);
+		if (!Check(name.c_str(), "Calculate_Fitness", scope.Stop().allocations)) failed++;
+
+		//a run reads the best solution's snapshot into its preallocated parameters, see Run_Solver
+		scope.Start();
+		problem->Get_Objective_Calls(total_calls, least_call, least_call_001, parameters_001);
+		if (!Check(name.c_str(), "best solution snapshot", scope.Stop().allocations)) failed++;
+
+		CConvergence_Trace trace;
+		trace.Record(std::numeric_limits<double>::max());
+		scope.Start();
+		for (size_t i = 0; i < Calls; i++)
+			trace.Record(problem->Calculate_Fitness(measured.data() + i * Problem_Size));
+		if (!Check(name.c_str(), "best-so-far trace", scope.Stop().allocations)) failed++;
+	}
+
+	//the objective's single, batch and cached paths, which also record the trace
+	failed += Verify_Allocation_Free_Objective(Problem_Size);
+
+	return failed == 0 ? 0 : 1;
+}